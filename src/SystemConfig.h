@@ -17,10 +17,17 @@
 // printf
 #define CONFIG_PRINTF_BUFFER            16
 
+// Console
+#define CONFIG_CONSOLE_TX_BUFFER_SIZE   1024
+
 // Debugging
 #define CONFIG_ENABLE_DEBUG             1
+#define CONFIG_DEBUG_LEVEL              4   // 0 = none, 1 = error, 2 = warning, 3 = info, 4 = debug
+#define CONFIG_ENABLE_DEBUG_TRACE       0
 #define CONFIG_ENABLE_PROFILER          0
+#define CONFIG_PROFILER_TIMELINE_SIZE   256
 #define CONFIG_ENABLE_TASK_PROFILER     1
+#define CONFIG_ENABLE_IRQ_PROFILER      1
 
 // Sanitization
 #define CONFIG_ENABLE_SANITIZE          1
@@ -15,7 +15,8 @@
 
 #define CONFIG_UPDATE_FILENAME      "UPDATE.DAT"
 
+// the last flash sector (sector 11) is reserved for settings and must not be erased by updates
 #define CONFIG_APPLICATION_ADDR     0x08010000
-#define CONFIG_APPLICATION_SIZE     0xF0000
+#define CONFIG_APPLICATION_SIZE     0xD0000
 #define CONFIG_VERSION_TAG_OFFSET   0x400
 #define CONFIG_VERSION_TAG_MAGIC    0xfadebabe
@@ -25,9 +25,9 @@
 #define CONFIG_FILE_TASK_STACK_SIZE     2048
 #define CONFIG_PROFILER_TASK_STACK_SIZE 2048
 
-// Settings flash storage
-#define CONFIG_SETTINGS_FLASH_SECTOR    3
-#define CONFIG_SETTINGS_FLASH_ADDR      0x0800C000
+// Settings flash storage (journal in two sectors, settings stored by older firmware are in the first sector)
+#define CONFIG_SETTINGS_FLASH_SECTOR0   3
+#define CONFIG_SETTINGS_FLASH_SECTOR1   11
 
 // Parts per quarter note
 #define CONFIG_PPQN                     192
@@ -57,6 +57,16 @@
 #define CONFIG_MIDI_OUTPUT_COUNT        8
 #define CONFIG_USER_SCALE_COUNT         4
 #define CONFIG_USER_SCALE_SIZE          32
+#define CONFIG_SET_LIST_ENTRY_COUNT     16
+
+// Live recording (note on/off events per track, 8 bytes each)
+#define CONFIG_RECORD_HISTORY_SIZE      32
+
+// MIDI file playback (events buffered per track)
+#define CONFIG_MIDI_FILE_STREAM_SIZE    32
+
+// Project switching (time in ms the file task has to start loading the project)
+#define CONFIG_PROJECT_SWITCH_TIMEOUT   2000
 
 
 #define CONFIG_ENABLE_ASTEROIDS
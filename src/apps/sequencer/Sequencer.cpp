@@ -20,6 +20,7 @@
 #include "os/os.h"
 
 #include "core/profiler/Profiler.h"
+#include "core/profiler/IrqProfiler.h"
 #include "core/fs/Volume.h"
 
 #include "model/Model.h"
@@ -100,6 +101,13 @@ static CCMRAM_BSS os::PeriodicTask<CONFIG_ENGINE_TASK_STACK_SIZE> engineTask("en
 });
 
 static CCMRAM_BSS os::PeriodicTask<CONFIG_USBH_TASK_STACK_SIZE> usbhTask("usbh", CONFIG_USBH_TASK_PRIORITY, os::time::ms(1), [] () {
+    // defer powering the usb host port until the scheduler is running to keep the
+    // inrush current and device enumeration out of the boot path
+    static bool poweredOn = false;
+    if (!poweredOn) {
+        usbh.powerOn();
+        poweredOn = true;
+    }
     usbh.process();
     taskAlive(2);
 });
@@ -118,10 +126,19 @@ static os::PeriodicTask<CONFIG_FILE_TASK_STACK_SIZE> fsTask("file", CONFIG_FILE_
 static CCMRAM_BSS os::PeriodicTask<CONFIG_PROFILER_TASK_STACK_SIZE> profilerTask("profiler", 0, os::time::ms(5000), [&] () {
 #if CONFIG_ENABLE_PROFILER
     profiler.dump();
+    profiler.dumpTrace();
+    profiler.reset();
+    Console::flush();
 #endif // CONFIG_ENABLE_PROFILE
 #if CONFIG_ENABLE_TASK_PROFILER
     os::TaskProfiler::dump();
+    Console::flush();
 #endif // CONFIG_ENABLE_TASK_PROFILER
+#if CONFIG_ENABLE_IRQ_PROFILER
+    IrqProfiler::dump();
+    Console::flush();
+#endif // CONFIG_ENABLE_IRQ_PROFILER
+    DBG_INFO("console dropped: %u", unsigned(Console::dropped()));
 });
 #endif // CONFIG_ENABLE_PROFILER || CONFIG_ENABLE_TASK_PROFILER
 
@@ -161,9 +178,10 @@ int main(void) {
     midi.init();
     usbMidi.init();
     usbh.init();
-    usbh.powerOn();
     sdCard.init();
 
+    // the sd card is mounted and the last project is loaded from the file task once
+    // the scheduler is running (see StartupPage)
     model.init();
     model.settings().readFromFlash();
 
@@ -0,0 +1,200 @@
+#include "SequencerApp.h"
+
+#include "sim/FrameCapture.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorThread.h"
+#include "sim/TargetConfig.h"
+#include "sim/TargetTrace.h"
+#include "sim/TargetTracePlayer.h"
+#include "sim/frontend/LcdImage.h"
+
+#include "args.hxx"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Runs the sequencer on the simulator thread without a frontend and reports
+// the target activity. Used to smoke test the threaded simulator, in particular
+// the WebAssembly build which can be run with node (node sequencer_headless.js).
+// With --replay, a captured trace (sequencer --capture-midi) is fed into the
+// simulator at the recorded ticks. The simulator is stepped on the main thread
+// as fast as possible, which makes MIDI heavy sessions reproducible and allows
+// benchmarking them offline.
+
+static constexpr int PlayButton = 24;
+
+struct ActivityCounter : public sim::TargetInputHandler, public sim::TargetOutputHandler {
+    int leds = 0;
+    int gates = 0;
+    int dacs = 0;
+    int frames = 0;
+    int midiInputs = 0;
+    int midiOutputs = 0;
+    // converts frames the same way as the frontend display
+    sim::LcdImage lcdImage { TargetConfig::LcdWidth, TargetConfig::LcdHeight, sim::Color(1.f, 1.f) };
+
+    void writeMidiInput(sim::MidiEvent event) override { ++midiInputs; }
+
+    void writeLed(int index, bool red, bool green) override { ++leds; }
+    void writeGateOutput(int channel, bool value) override { ++gates; }
+    void writeDac(int channel, uint16_t value) override { ++dacs; }
+    void writeLcd(const sim::FrameBuffer &frameBuffer) override {
+        lcdImage.update(frameBuffer.data());
+        ++frames;
+    }
+    void writeMidiOutput(sim::MidiEvent event) override { ++midiOutputs; }
+
+    void report() const {
+        std::cout << "lcd frames: " << frames << std::endl;
+        std::cout << "lcd rows converted: " << lcdImage.convertedRows()
+                  << " (" << frames * TargetConfig::LcdHeight << " without dirty row tracking)" << std::endl;
+        std::cout << "led updates: " << leds << std::endl;
+        std::cout << "gate updates: " << gates << std::endl;
+        std::cout << "dac updates: " << dacs << std::endl;
+        std::cout << "midi input events: " << midiInputs << std::endl;
+        std::cout << "midi output events: " << midiOutputs << std::endl;
+    }
+};
+
+static int replay(sim::Simulator &sim, const std::string &filename, int duration, bool play) {
+    sim::TargetTrace trace;
+    trace.loadFromFile(filename);
+    const auto &events = trace.midiInput.items();
+    if (events.empty()) {
+        std::cerr << "No MIDI events in '" << filename << "'" << std::endl;
+        return 1;
+    }
+
+    ActivityCounter counter;
+    sim::TargetTracePlayer player(trace, &sim, nullptr);
+    sim.registerTargetTickObserver(&player);
+    sim.registerTargetInputObserver(&counter);
+    sim.registerTargetOutputObserver(&counter);
+
+    // run until all events are replayed, unless a duration was given
+    uint32_t endTick = duration > 0 ? duration : events.back().first + 1000;
+
+    auto start = std::chrono::steady_clock::now();
+    while (sim.ticks() < endTick) {
+        if (play && sim.ticks() == 3000) {
+            sim.writeButton(PlayButton, true);
+            sim.writeButton(PlayButton, false);
+        }
+        sim.wait(1);
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    sim.unregisterTargetTickObserver(&player);
+    sim.unregisterTargetInputObserver(&counter);
+    sim.unregisterTargetOutputObserver(&counter);
+
+    std::cout << "ticks: " << sim.ticks() << std::endl;
+    std::cout << "replayed events: " << events.size() << " (last at tick " << events.back().first << ")" << std::endl;
+    counter.report();
+    std::cout << "elapsed: " << elapsed << " ms (" << sim.ticks() / elapsed << "x real time)" << std::endl;
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    args::ArgumentParser parser("PER|FORMER Headless Simulator", "");
+    args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
+    args::ValueFlag<int> duration(parser, "ms", "Time to run the simulator (default 5000, or until the end of the replayed trace)", { 'd', "duration" });
+    args::Flag play(parser, "play", "Start playback after startup", { 'p', "play" });
+    args::ValueFlag<std::string> screenshot(parser, "file", "Write screenshot when done", { "screenshot" });
+    args::ValueFlag<std::string> replayTrace(parser, "file", "Replay captured MIDI trace as fast as possible", { "replay" });
+    args::ValueFlag<std::string> captureFrames(parser, "dir", "Capture LCD frames as PNG image sequence into directory", { "capture-frames" });
+    args::ValueFlag<std::string> captureVideo(parser, "file", "Capture LCD frames as raw RGB video stream", { "capture-video" });
+    args::Flag captureLeds(parser, "leds", "Include LEDs in captured frames", { "capture-leds" });
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const args::Help &) {
+        std::cout << parser;
+        return 0;
+    } catch (const args::ParseError &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::unique_ptr<SequencerApp> app;
+
+    sim::Simulator sim({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+
+    std::unique_ptr<sim::FrameCapture> frameCapture;
+    if (captureFrames) {
+        frameCapture.reset(new sim::FrameCapture(sim, args::get(captureFrames), sim::FrameCapture::Format::Png, captureLeds));
+    } else if (captureVideo) {
+        frameCapture.reset(new sim::FrameCapture(sim, args::get(captureVideo), sim::FrameCapture::Format::Raw, captureLeds));
+    }
+    auto reportCapture = [&] () {
+        if (frameCapture) {
+            frameCapture->close();
+            std::cout << "captured frames: " << frameCapture->capturedFrames() << " of " << frameCapture->frames()
+                      << " (" << frameCapture->width() << "x" << frameCapture->height() << ")" << std::endl;
+            return !frameCapture->failed();
+        }
+        return true;
+    };
+
+    if (replayTrace) {
+        int result = replay(sim, args::get(replayTrace), duration ? args::get(duration) : 0, play);
+        if (!reportCapture()) {
+            result = 1;
+        }
+        if (result == 0 && screenshot) {
+            sim.screenshot(args::get(screenshot));
+        }
+        return result;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto ticks = [start] () {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    sim::SimulatorThread thread(sim, ticks);
+    ActivityCounter counter;
+    bool playing = false;
+
+    thread.start();
+    int runDuration = duration ? args::get(duration) : 5000;
+    while (ticks() < runDuration) {
+        // press play once startup is done
+        if (play && !playing && ticks() > 3000) {
+            thread.writeButton(PlayButton, true);
+            thread.writeButton(PlayButton, false);
+            playing = true;
+        }
+        thread.poll(counter, counter);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    thread.stop();
+    thread.poll(counter, counter);
+
+    std::cout << "ticks: " << sim.ticks() << std::endl;
+    counter.report();
+    std::cout << "dropped events: " << thread.dropped() << std::endl;
+    bool captured = reportCapture();
+
+    if (screenshot) {
+        sim.screenshot(args::get(screenshot));
+    }
+
+    // the target is expected to at least draw the display
+    return counter.frames > 0 && captured ? 0 : 1;
+}
@@ -407,10 +407,6 @@ void Clock::outputMidiMessage(uint8_t msg) {
 void Clock::outputTick(uint32_t tick) {
     outputReset(false);
 
-    if (tick % (_ppqn / 24) == 0) {
-        outputMidiMessage(MidiMessage::Tick);
-    }
-
     // generate output clock with swing
 
     auto applySwing = [this] (uint32_t tick) {
@@ -434,6 +430,11 @@ void Clock::outputTick(uint32_t tick) {
     if (tick == _output.nextTickOff) {
         outputClock(false);
     }
+
+    // the midi clock is dispatched after the clock output edges to not delay them
+    if (tick % (_ppqn / 24) == 0) {
+        outputMidiMessage(MidiMessage::Tick);
+    }
 }
 
 void Clock::outputClock(bool clock) {
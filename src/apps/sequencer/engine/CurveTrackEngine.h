@@ -34,6 +34,9 @@ public:
         return _currentStep < 0 ? 0.f : float(_currentStep - _sequence->firstStep()) / (_sequence->lastStep() - _sequence->firstStep());
     }
 
+    virtual int gateQueueHighWater() const override { return _gateQueue.highWater(); }
+    virtual void resetQueueHighWater() override { _gateQueue.resetHighWater(); }
+
     const CurveSequence &sequence() const { return *_sequence; }
     bool isActiveSequence(const CurveSequence &sequence) const { return &sequence == _sequence; }
 
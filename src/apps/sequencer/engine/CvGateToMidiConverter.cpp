@@ -0,0 +1,130 @@
+#include "CvGateToMidiConverter.h"
+
+#include "core/math/Math.h"
+
+#include <algorithm>
+
+#include <cmath>
+
+CvGateToMidiConverter::CvGateToMidiConverter() {
+    reset(0);
+}
+
+void CvGateToMidiConverter::setVoices(const Voice *voices, int count, uint32_t tick) {
+    reset(tick);
+    _voiceCount = std::min(count, int(MaxVoices));
+    for (int i = 0; i < _voiceCount; ++i) {
+        _voices[i] = voices[i];
+    }
+}
+
+void CvGateToMidiConverter::reset(uint32_t tick) {
+    for (int i = 0; i < _voiceCount; ++i) {
+        noteOff(i, tick);
+    }
+    for (auto &state : _voiceStates) {
+        state.gate = false;
+        state.note = -1;
+        state.pendingUpdates = -1;
+        state.gateTick = 0;
+        state.lastPitch = 0.f;
+    }
+}
+
+void CvGateToMidiConverter::process(const float *channels, uint32_t tick) {
+    for (int i = 0; i < _voiceCount; ++i) {
+        const auto &voice = _voices[i];
+        processVoice(i, channels[voice.pitchChannel], channels[voice.gateChannel], tick);
+    }
+}
+
+bool CvGateToMidiConverter::read(Event &event) {
+    if (_events.empty()) {
+        return false;
+    }
+    event = _events.read();
+    return true;
+}
+
+void CvGateToMidiConverter::processVoice(int index, float pitchCv, float gateCv, uint32_t tick) {
+    auto &state = _voiceStates[index];
+
+    float pitch = pitchCv * 12.f;
+    bool gliding = std::abs(pitch - state.lastPitch) > _config.glideThreshold;
+    state.lastPitch = pitch;
+    int note = clamp(60 + int(std::floor(pitch + 0.5f)), 0, 127);
+
+    if (!state.gate) {
+        if (gateCv <= _config.gateOnThreshold) {
+            return;
+        }
+        // gate on, the note on is sent once the pitch has settled
+        state.gate = true;
+        state.gateTick = tick;
+        state.pendingUpdates = _config.maxSettleUpdates;
+    } else if (gateCv < _config.gateOffThreshold) {
+        // gate off, send pending note on of short gates
+        if (state.pendingUpdates >= 0) {
+            noteOn(index, note, state.gateTick);
+            state.pendingUpdates = -1;
+        }
+        noteOff(index, tick);
+        state.gate = false;
+        return;
+    }
+
+    if (state.pendingUpdates >= 0) {
+        if (gliding && state.pendingUpdates > 0) {
+            --state.pendingUpdates;
+            return;
+        }
+        // note on is timestamped with the gate on
+        noteOn(index, note, state.gateTick);
+        state.pendingUpdates = -1;
+        return;
+    }
+
+    // legato note change once the pitch has settled outside of the current note
+    if (!gliding && state.note != -1 && std::abs(pitch - (state.note - 60)) > 0.5f + _config.pitchHysteresis) {
+        int lastNote = state.note;
+        noteOn(index, note, tick);
+        if (!isNoteHeld(-1, lastNote, _voices[index].midiChannel)) {
+            push(tick, MidiMessage::makeNoteOff(_voices[index].midiChannel, lastNote, 0));
+        }
+    }
+}
+
+void CvGateToMidiConverter::noteOn(int index, int note, uint32_t tick) {
+    // voices sharing a MIDI channel only send a single note on for the same note
+    if (!isNoteHeld(index, note, _voices[index].midiChannel)) {
+        push(tick, MidiMessage::makeNoteOn(_voices[index].midiChannel, note, 127));
+    }
+    _voiceStates[index].note = note;
+}
+
+void CvGateToMidiConverter::noteOff(int index, uint32_t tick) {
+    auto &state = _voiceStates[index];
+    if (state.note == -1) {
+        return;
+    }
+    // note off is only sent once the last voice playing the note is released
+    if (!isNoteHeld(index, state.note, _voices[index].midiChannel)) {
+        push(tick, MidiMessage::makeNoteOff(_voices[index].midiChannel, state.note, 0));
+    }
+    state.note = -1;
+}
+
+bool CvGateToMidiConverter::isNoteHeld(int excludeIndex, int note, uint8_t midiChannel) const {
+    for (int i = 0; i < _voiceCount; ++i) {
+        if (i != excludeIndex && _voices[i].midiChannel == midiChannel && _voiceStates[i].note == note) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CvGateToMidiConverter::push(uint32_t tick, const MidiMessage &message) {
+    if (!_events.full()) {
+        _events.write({ tick, message });
+    }
+}
@@ -1,49 +1,79 @@
 #pragma once
 
+#include "Config.h"
+
 #include "core/midi/MidiMessage.h"
-#include "core/math/Math.h"
+#include "core/utils/RingBuffer.h"
+
+#include <array>
 
-#include <functional>
+#include <cstdint>
 
+// Converts pairs of pitch/gate CV inputs to MIDI note messages.
+// Gates are detected with separate on/off thresholds. Note changes while the gate is high use
+// hysteresis around the semitone boundaries and are held back while the pitch is gliding, so
+// jitter and portamento do not result in bursts of notes. Events are timestamped with the tick
+// at which the CV inputs were sampled and buffered until the engine reads them.
 class CvGateToMidiConverter {
 public:
-    CvGateToMidiConverter() {
-        reset();
-    }
-
-    void reset() {
-        _gate = 0;
-        _note = -1;
-    }
-
-    void convert(float pitchCv, float gateCv, uint8_t channel, std::function<void(const MidiMessage &message)> callback) {
-        int8_t note = clamp(60 + int(std::floor(pitchCv * 12.f + 0.5f)), 0, 127);
-
-        if (_gate) {
-            if (gateCv < 2.f) {
-                // gate off
-                if (_note != -1) {
-                    callback(MidiMessage::makeNoteOff(channel, _note, 0));
-                    _note = -1;
-                }
-                _gate = 0;
-            } else if (note != _note) {
-                // legato note change
-                callback(MidiMessage::makeNoteOn(channel, note, 127));
-                callback(MidiMessage::makeNoteOff(channel, _note, 0));
-                _note = note;
-            }
-        } else {
-            if (gateCv > 3.f) {
-                // gate on
-                callback(MidiMessage::makeNoteOn(channel, note, 127));
-                _gate = 1;
-                _note = note;
-            }
-        }
-    }
+    static constexpr int MaxVoices = CONFIG_CV_INPUT_CHANNELS / 2;
+
+    struct Config {
+        float gateOnThreshold = 3.f;        // volts
+        float gateOffThreshold = 2.f;       // volts
+        float pitchHysteresis = 0.2f;       // semitones beyond the note boundary
+        float glideThreshold = 0.05f;       // semitones per update, pitch is gliding above this
+        uint8_t maxSettleUpdates = 3;       // updates to wait for the pitch to settle after a gate on
+    };
+
+    struct Voice {
+        uint8_t pitchChannel;
+        uint8_t gateChannel;
+        uint8_t midiChannel;
+    };
+
+    struct Event {
+        uint32_t tick;
+        MidiMessage message;
+    };
+
+    CvGateToMidiConverter();
+
+    const Config &config() const { return _config; }
+    void setConfig(const Config &config) { _config = config; }
+
+    // sets the voice mapping, active notes of the previous mapping are released
+    void setVoices(const Voice *voices, int count, uint32_t tick);
+
+    // releases all active notes
+    void reset(uint32_t tick);
+
+    // processes the sampled CV input channels (in volts)
+    void process(const float *channels, uint32_t tick);
+
+    // reads the next event, returns false if no event is buffered
+    bool read(Event &event);
 
 private:
-    uint8_t _gate;
-    int8_t _note;
+    struct VoiceState {
+        bool gate;
+        int8_t note;
+        int8_t pendingUpdates;  // updates left to settle before sending the note on, -1 if not pending
+        uint32_t gateTick;
+        float lastPitch;        // semitones
+    };
+
+    void processVoice(int index, float pitchCv, float gateCv, uint32_t tick);
+
+    void noteOn(int index, int note, uint32_t tick);
+    void noteOff(int index, uint32_t tick);
+    bool isNoteHeld(int excludeIndex, int note, uint8_t midiChannel) const;
+    void push(uint32_t tick, const MidiMessage &message);
+
+    Config _config;
+    std::array<Voice, MaxVoices> _voices;
+    std::array<VoiceState, MaxVoices> _voiceStates;
+    int _voiceCount = 0;
+
+    RingBuffer<Event, 16> _events;
 };
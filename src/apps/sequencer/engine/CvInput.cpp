@@ -9,7 +9,8 @@ void CvInput::init() {
     _channels.fill(0.f);
 }
 
-void CvInput::update() {
+void CvInput::update(uint32_t tick) {
+    _tick = tick;
     for (int i = 0; i < Channels; ++i) {
         _channels[i] = 5.f - _adc.channel(i) / 6553.5f;
     }
@@ -14,14 +14,20 @@ public:
 
     void init();
 
-    void update();
+    // samples the inputs, tick is the current clock tick used to timestamp the samples
+    void update(uint32_t tick);
 
     float channel(int index) const {
         return _channels[index];
     }
 
+    const std::array<float, Channels> &channels() const { return _channels; }
+
+    uint32_t tick() const { return _tick; }
+
 private:
     Adc &_adc;
 
     std::array<float, Channels> _channels;
+    uint32_t _tick = 0;
 };
@@ -4,6 +4,10 @@
 
 #include "core/Debug.h"
 #include "core/midi/MidiMessage.h"
+#include "core/profiler/Profiler.h"
+#include "core/profiler/ProfilerTimer.h"
+
+#include "model/FileManager.h"
 
 #include "os/os.h"
 
@@ -25,6 +29,9 @@ Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &di
 
     _usbMidi.setConnectHandler([this] (uint16_t vendorId, uint16_t productId) { usbMidiConnect(vendorId, productId); });
     _usbMidi.setDisconnectHandler([this] () { usbMidiDisconnect(); });
+
+    _midi.setSysExHandler([this] (const MidiParser::SysExChunk &chunk) { receiveSysEx(MidiPort::Midi, chunk); });
+    _usbMidi.setSysExHandler([this] (const MidiParser::SysExChunk &chunk) { receiveSysEx(MidiPort::UsbMidi, chunk); });
 }
 
 void Engine::init() {
@@ -35,6 +42,14 @@ void Engine::init() {
     initClock();
     updateClockSetup();
 
+    // midi file streams are filled by the file task
+    FileManager::setStreamCallback([this] () {
+        processProjectSwitch();
+        for (auto &midiFileStream : _midiFileStreams) {
+            midiFileStream.process();
+        }
+    });
+
     // setup track engines
     updateTrackSetups();
     reset();
@@ -43,6 +58,25 @@ void Engine::init() {
 }
 
 void Engine::update() {
+    PROFILER_SCOPE(update, "engine.update")
+
+    // record the update time for the statistics on every return path
+    struct UpdateTimeScope {
+        UpdateTimeScope(UpdateTime &updateTime) : updateTime(updateTime), start(ProfilerTimer::us()) {}
+        ~UpdateTimeScope() { updateTime.record(ProfilerTimer::us() - start); }
+        UpdateTime &updateTime;
+        uint32_t start;
+    };
+
+    if (_requestStatsReset) {
+        _updateTime = UpdateTime();
+        for (auto trackEngine : _trackEngines) {
+            trackEngine->resetQueueHighWater();
+        }
+        _requestStatsReset = 0;
+    }
+    UpdateTimeScope updateTimeScope(_updateTime);
+
     uint32_t systemTicks = os::ticks();
     float dt = (0.001f * (systemTicks - _lastSystemTicks)) / os::time::ms(1);
     _lastSystemTicks = systemTicks;
@@ -68,13 +102,23 @@ void Engine::update() {
         while (_midi.recv(&message)) {}
         while (_usbMidi.recv(&message)) {}
 
-        _cvInput.update();
+        _cvInput.update(_clock.tick());
         updateOverrides();
         _cvOutput.update();
         _gateOutput.update();
         return;
     }
 
+    // project switching
+    if (projectSuspended()) {
+        auto state = ProjectSwitchState(_projectSwitchState);
+        if (state != ProjectSwitchState::Loaded && state != ProjectSwitchState::TimedOut) {
+            updateSuspended();
+            return;
+        }
+        resumeProject();
+    }
+
     // process clock events
     while (Clock::Event event = _clock.checkEvent()) {
         switch (event) {
@@ -99,6 +143,12 @@ void Engine::update() {
         }
     }
 
+    // switch project right away if not playing
+    if (ProjectSwitchState(_projectSwitchState) == ProjectSwitchState::Requested && !_state.running()) {
+        suspendProject();
+        return;
+    }
+
     // update tempo
     _nudgeTempo.update(dt);
     _clock.setMasterBpm(_project.tempo() * (1.f + _nudgeTempo.strength() * 0.1f));
@@ -113,7 +163,7 @@ void Engine::update() {
     updatePlayState(false);
 
     // update cv inputs
-    _cvInput.update();
+    _cvInput.update(_clock.tick());
 
     // receive midi events
     receiveMidi();
@@ -125,6 +175,12 @@ void Engine::update() {
     while (_clock.checkTick(&tick)) {
         _tick = tick;
 
+        // switch project on bar boundary
+        if (ProjectSwitchState(_projectSwitchState) == ProjectSwitchState::Requested && _tick % measureDivisor() == 0) {
+            suspendProject();
+            return;
+        }
+
         // update play state
         updatePlayState(true);
 
@@ -170,6 +226,16 @@ bool Engine::isLocked() {
     return _locked == 1;
 }
 
+bool Engine::requestProjectSwitch(ProjectLoadHandler load, ProjectSwitchResultHandler result) {
+    if (projectSwitchPending()) {
+        return false;
+    }
+    _projectLoadHandler = load;
+    _projectSwitchResultHandler = result;
+    _projectSwitchState = uint8_t(ProjectSwitchState::Requested);
+    return true;
+}
+
 void Engine::togglePlay(bool shift) {
     if (shift) {
         switch (_project.clockSetup().shiftMode()) {
@@ -292,6 +358,80 @@ bool Engine::sendMidi(MidiPort port, const MidiMessage &message) {
     return false;
 }
 
+bool Engine::sendSysEx(MidiPort port, const uint8_t *data, size_t length) {
+    bool queued = false;
+    switch (port) {
+    case MidiPort::Midi:
+        queued = _midi.sendSysEx(data, length);
+        break;
+    case MidiPort::UsbMidi:
+        queued = _usbMidi.sendSysEx(data, length);
+        break;
+    case MidiPort::CvGate:
+        // input only
+        break;
+    }
+    if (queued) {
+        _sysExTxBytes += length;
+    }
+    return queued;
+}
+
+bool Engine::beginSysEx(MidiPort port) {
+    bool queued = false;
+    switch (port) {
+    case MidiPort::Midi:
+        queued = _midi.beginSysEx();
+        break;
+    case MidiPort::UsbMidi:
+        queued = _usbMidi.beginSysEx();
+        break;
+    case MidiPort::CvGate:
+        // input only
+        break;
+    }
+    if (queued) {
+        _sysExTxBytes += 1;
+    }
+    return queued;
+}
+
+size_t Engine::appendSysEx(MidiPort port, const uint8_t *data, size_t length) {
+    size_t queued = 0;
+    switch (port) {
+    case MidiPort::Midi:
+        queued = _midi.appendSysEx(data, length);
+        break;
+    case MidiPort::UsbMidi:
+        queued = _usbMidi.appendSysEx(data, length);
+        break;
+    case MidiPort::CvGate:
+        // input only
+        break;
+    }
+    _sysExTxBytes += queued;
+    return queued;
+}
+
+bool Engine::endSysEx(MidiPort port) {
+    bool queued = false;
+    switch (port) {
+    case MidiPort::Midi:
+        queued = _midi.endSysEx();
+        break;
+    case MidiPort::UsbMidi:
+        queued = _usbMidi.endSysEx();
+        break;
+    case MidiPort::CvGate:
+        // input only
+        break;
+    }
+    if (queued) {
+        _sysExTxBytes += 1;
+    }
+    return queued;
+}
+
 void Engine::showMessage(const char *text, uint32_t duration) {
     if (_messageHandler) {
         _messageHandler(text, duration);
@@ -303,10 +443,24 @@ void Engine::setMessageHandler(MessageHandler handler) {
 }
 
 Engine::Stats Engine::stats() const {
+    uint32_t gateQueueHighWater = 0;
+    uint32_t cvQueueHighWater = 0;
+    for (auto trackEngine : _trackEngines) {
+        gateQueueHighWater = std::max(gateQueueHighWater, uint32_t(trackEngine->gateQueueHighWater()));
+        cvQueueHighWater = std::max(cvQueueHighWater, uint32_t(trackEngine->cvQueueHighWater()));
+    }
+
     return {
         .uptime = os::ticks() / os::time::ms(1000),
         .midiRxOverflow = _midi.rxOverflow(),
-        .usbMidiRxOverflow = _usbMidi.rxOverflow()
+        .midiTxOverflow = _midi.txOverflow(),
+        .usbMidiRxOverflow = _usbMidi.rxOverflow(),
+        .sysExRxBytes = _sysExRxBytes,
+        .sysExTxBytes = _sysExTxBytes,
+        .updateTimeMean = _updateTime.count > 0 ? uint32_t(_updateTime.total / _updateTime.count) : 0,
+        .updateTimeMax = _updateTime.max,
+        .gateQueueHighWater = gateQueueHighWater,
+        .cvQueueHighWater = cvQueueHighWater
     };
 }
 
@@ -345,6 +499,8 @@ void Engine::updateTrackSetups() {
             auto &trackEngine = _trackEngines[trackIndex];
             auto &trackContainer = _trackEngineContainers[trackIndex];
 
+            _midiFileStreams[trackIndex].close();
+
             switch (track.trackMode()) {
             case Track::TrackMode::Note:
                 trackEngine = trackContainer.create<NoteTrackEngine>(*this, _model, track, linkedTrackEngine);
@@ -355,6 +511,9 @@ void Engine::updateTrackSetups() {
             case Track::TrackMode::MidiCv:
                 trackEngine = trackContainer.create<MidiCvTrackEngine>(*this, _model, track, linkedTrackEngine);
                 break;
+            case Track::TrackMode::MidiFile:
+                trackEngine = trackContainer.create<MidiFileTrackEngine>(*this, _model, track, linkedTrackEngine);
+                break;
             case Track::TrackMode::Last:
                 break;
             }
@@ -534,6 +693,89 @@ void Engine::updatePlayState(bool ticked) {
     }
 }
 
+void Engine::suspendProject() {
+    // silence track engines, this is the last access to the project until it is replaced
+    reset();
+    updateTrackOutputs();
+    updateOverrides();
+    _cvOutput.update();
+    _gateOutput.update();
+
+    // the project is loaded by the file task, see processProjectSwitch()
+    _projectSuspendTicks = os::ticks();
+    _projectSwitchState = uint8_t(ProjectSwitchState::Suspended);
+}
+
+void Engine::resumeProject() {
+    bool timedOut = ProjectSwitchState(_projectSwitchState) == ProjectSwitchState::TimedOut;
+    auto resultHandler = _projectSwitchResultHandler;
+    _projectSwitchTime = os::ticks() - _projectSuspendTicks;
+    _projectSwitchState = uint8_t(ProjectSwitchState::Idle);
+
+    if (timedOut && resultHandler) {
+        resultHandler(fs::TIMEOUT);
+    }
+
+    updateTrackSetups();
+    reset();
+
+    // the last tick was consumed while suspended, play it with the new project
+    if (_state.running()) {
+        updatePlayState(true);
+        for (auto trackEngine : _trackEngines) {
+            trackEngine->tick(_tick);
+        }
+        _midiOutputEngine.tick(_tick);
+    }
+}
+
+void Engine::updateSuspended() {
+    // resume with the current project if the file task did not start loading in time
+    if (os::ticks() - _projectSuspendTicks > os::time::ms(CONFIG_PROJECT_SWITCH_TIMEOUT)) {
+        os::InterruptLock lock;
+        if (ProjectSwitchState(_projectSwitchState) == ProjectSwitchState::Suspended) {
+            _projectSwitchState = uint8_t(ProjectSwitchState::TimedOut);
+        }
+    }
+
+    // keep the clock running, clock events are handled after resuming
+    uint32_t tick;
+    while (_clock.checkTick(&tick)) {
+        _tick = tick;
+    }
+
+    // consume midi events
+    MidiMessage message;
+    while (_midi.recv(&message)) {}
+    while (_usbMidi.recv(&message)) {}
+
+    _cvInput.update(_clock.tick());
+    updateOverrides();
+    _cvOutput.update();
+    _gateOutput.update();
+}
+
+void Engine::processProjectSwitch() {
+    {
+        // the engine might time out concurrently
+        os::InterruptLock lock;
+        if (ProjectSwitchState(_projectSwitchState) != ProjectSwitchState::Suspended) {
+            return;
+        }
+        _projectSwitchState = uint8_t(ProjectSwitchState::Loading);
+    }
+
+    fs::Error result = _projectLoadHandler();
+    auto resultHandler = _projectSwitchResultHandler;
+
+    // the engine resumes in any case, the load handler has to leave a valid project behind if loading fails
+    _projectSwitchState = uint8_t(ProjectSwitchState::Loaded);
+
+    if (resultHandler) {
+        resultHandler(result);
+    }
+}
+
 void Engine::updateOverrides() {
     // overrides
     if (_gateOutputOverride) {
@@ -562,34 +804,58 @@ void Engine::receiveMidi() {
     MidiMessage message;
     while (_midi.recv(&message)) {
         message.fixFakeNoteOff();
-        receiveMidi(MidiPort::Midi, message);
+        receiveMidi(MidiPort::Midi, message, _tick);
     }
     while (_usbMidi.recv(&message)) {
         message.fixFakeNoteOff();
-        receiveMidi(MidiPort::UsbMidi, message);
+        receiveMidi(MidiPort::UsbMidi, message, _tick);
     }
 
     // derive MIDI messages from CV/Gate input
-    switch (_project.cvGateInput()) {
+    if (_project.cvGateInput() != _cvGateInput) {
+        _cvGateInput = _project.cvGateInput();
+        updateCvGateToMidiVoices();
+    }
+    _cvGateToMidiConverter.process(_cvInput.channels().data(), _cvInput.tick());
+
+    CvGateToMidiConverter::Event event;
+    while (_cvGateToMidiConverter.read(event)) {
+        receiveMidi(MidiPort::CvGate, event.message, event.tick);
+    }
+}
+
+void Engine::updateCvGateToMidiVoices() {
+    typedef CvGateToMidiConverter::Voice Voice;
+
+    switch (_cvGateInput) {
     case Types::CvGateInput::Off:
-        _cvGateToMidiConverter.reset();
+    case Types::CvGateInput::Last:
+        _cvGateToMidiConverter.setVoices(nullptr, 0, _cvInput.tick());
         break;
-    case Types::CvGateInput::Cv1Cv2:
-        _cvGateToMidiConverter.convert(_cvInput.channel(0), _cvInput.channel(1), 0, [this] (const MidiMessage &message) {
-            receiveMidi(MidiPort::CvGate, message);
-        });
+    case Types::CvGateInput::Cv1Cv2: {
+        const Voice voices[] = { { 0, 1, 0 } };
+        _cvGateToMidiConverter.setVoices(voices, 1, _cvInput.tick());
         break;
-    case Types::CvGateInput::Cv3Cv4:
-        _cvGateToMidiConverter.convert(_cvInput.channel(2), _cvInput.channel(3), 1, [this] (const MidiMessage &message) {
-            receiveMidi(MidiPort::CvGate, message);
-        });
+    }
+    case Types::CvGateInput::Cv3Cv4: {
+        const Voice voices[] = { { 2, 3, 1 } };
+        _cvGateToMidiConverter.setVoices(voices, 1, _cvInput.tick());
         break;
-    case Types::CvGateInput::Last:
+    }
+    case Types::CvGateInput::Poly: {
+        const Voice voices[] = { { 0, 1, 0 }, { 2, 3, 0 } };
+        _cvGateToMidiConverter.setVoices(voices, 2, _cvInput.tick());
         break;
     }
+    }
 }
 
-void Engine::receiveMidi(MidiPort port, const MidiMessage &message) {
+void Engine::receiveMidi(MidiPort port, const MidiMessage &message, uint32_t tick) {
+    // log messages for monitoring, real-time messages would flood the log
+    if (!message.isRealTimeMessage()) {
+        _midiLog.write(tick, port, message);
+    }
+
     // filter out real-time and system messages
     if (message.isRealTimeMessage() || message.isSystemMessage()) {
         return;
@@ -620,13 +886,13 @@ void Engine::receiveMidi(MidiPort port, const MidiMessage &message) {
     }
 
     // midi monitoring (and recording)
-    monitorMidi(message);
+    monitorMidi(message, tick);
 }
 
-void Engine::monitorMidi(const MidiMessage &message) {
+void Engine::monitorMidi(const MidiMessage &message, uint32_t tick) {
     // helper to send monitor message to a track engine
-    auto sendMidi = [this] (int trackIndex, const MidiMessage &message) {
-        _trackEngines[trackIndex]->monitorMidi(_tick, message);
+    auto sendMidi = [this, tick] (int trackIndex, const MidiMessage &message) {
+        _trackEngines[trackIndex]->monitorMidi(tick, message);
     };
 
     auto currentTrack = _project.selectedTrackIndex();
@@ -653,6 +919,13 @@ void Engine::monitorMidi(const MidiMessage &message) {
     }
 }
 
+void Engine::receiveSysEx(MidiPort port, const MidiParser::SysExChunk &chunk) {
+    _sysExRxBytes += chunk.length;
+    if (_sysExReceiveHandler) {
+        _sysExReceiveHandler(port, chunk);
+    }
+}
+
 void Engine::initClock() {
     _clock.setListener(this);
 
@@ -8,12 +8,15 @@
 #include "NoteTrackEngine.h"
 #include "CurveTrackEngine.h"
 #include "MidiCvTrackEngine.h"
+#include "MidiFileTrackEngine.h"
+#include "MidiFileStream.h"
 #include "CvInput.h"
 #include "CvOutput.h"
 #include "RoutingEngine.h"
 #include "MidiOutputEngine.h"
 #include "MidiPort.h"
 #include "MidiLearn.h"
+#include "MidiLog.h"
 #include "CvGateToMidiConverter.h"
 
 #include "model/Model.h"
@@ -32,17 +35,22 @@
 
 class Engine : private Clock::Listener {
 public:
-    typedef Container<NoteTrackEngine, CurveTrackEngine, MidiCvTrackEngine> TrackEngineContainer;
+    typedef Container<NoteTrackEngine, CurveTrackEngine, MidiCvTrackEngine, MidiFileTrackEngine> TrackEngineContainer;
     typedef std::array<TrackEngineContainer, CONFIG_TRACK_COUNT> TrackEngineContainerArray;
     typedef std::array<TrackEngine *, CONFIG_TRACK_COUNT> TrackEngineArray;
+    typedef std::array<MidiFileStream, CONFIG_TRACK_COUNT> MidiFileStreamArray;
 
     typedef std::function<bool(MidiPort port, const MidiMessage &message)> MidiReceiveHandler;
+    typedef std::function<void(MidiPort port, const MidiParser::SysExChunk &chunk)> SysExReceiveHandler;
 
     typedef std::function<void(uint16_t vendorId, uint16_t productId)> UsbMidiConnectHandler;
     typedef std::function<void()> UsbMidiDisconnectHandler;
 
     typedef std::function<void(const char *text, uint32_t duration)> MessageHandler;
 
+    typedef std::function<fs::Error(void)> ProjectLoadHandler;
+    typedef std::function<void(fs::Error)> ProjectSwitchResultHandler;
+
     enum ClockSource {
         ClockSourceExternal,
         ClockSourceMidi,
@@ -52,7 +60,14 @@ public:
     struct Stats {
         uint32_t uptime;
         uint32_t midiRxOverflow;
+        uint32_t midiTxOverflow;
         uint32_t usbMidiRxOverflow;
+        uint32_t sysExRxBytes;
+        uint32_t sysExTxBytes;
+        uint32_t updateTimeMean;    // us
+        uint32_t updateTimeMax;     // us
+        uint32_t gateQueueHighWater;
+        uint32_t cvQueueHighWater;
     };
 
     Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi);
@@ -65,6 +80,21 @@ public:
     void unlock();
     bool isLocked();
 
+    // project switching
+    // Track engines are suspended on the next bar boundary (or immediately if the clock is not running).
+    // The engine only raises projectSuspended(), the load handler is then called from the file task to replace
+    // the project. The clock keeps running while the project is replaced and track engines are resumed in sync
+    // once the load handler returns, whether it succeeded or not. A failed load may leave a partially read
+    // project, the load handler has to reset it to a valid state before returning. If the file task does not
+    // start loading within CONFIG_PROJECT_SWITCH_TIMEOUT, the engine resumes with the current project and
+    // reports fs::TIMEOUT.
+    // The result handler is called from the file task (or the engine task on timeout).
+    bool requestProjectSwitch(ProjectLoadHandler load, ProjectSwitchResultHandler result);
+    bool projectSwitchPending() const { return ProjectSwitchState(_projectSwitchState) != ProjectSwitchState::Idle; }
+    bool projectSuspended() const { return ProjectSwitchState(_projectSwitchState) >= ProjectSwitchState::Suspended; }
+    // time in ms track engines were suspended during the last project switch
+    uint32_t projectSwitchTime() const { return _projectSwitchTime; }
+
     // clock control
     void togglePlay(bool shift = false);
     void clockStart();
@@ -131,6 +161,10 @@ public:
     const MidiOutputEngine &midiOutputEngine() const { return _midiOutputEngine; }
           MidiOutputEngine &midiOutputEngine()       { return _midiOutputEngine; }
 
+    // midi file streams (serviced by the file task)
+    const MidiFileStream &midiFileStream(int trackIndex) const { return _midiFileStreams[trackIndex]; }
+          MidiFileStream &midiFileStream(int trackIndex)       { return _midiFileStreams[trackIndex]; }
+
     const MidiLearn &midiLearn() const { return _midiLearn; }
           MidiLearn &midiLearn()       { return _midiLearn; }
 
@@ -138,6 +172,17 @@ public:
 
     bool sendMidi(MidiPort port, const MidiMessage &message);
     void setMidiReceiveHandler(MidiReceiveHandler handler) { _midiReceiveHandler = handler; }
+
+    // SysEx messages are sent without blocking, a message is only queued if it fits into the transmit buffer
+    // and sendSysEx() returns false otherwise. Larger messages are streamed with beginSysEx(), appendSysEx()
+    // (returns the number of queued bytes) and endSysEx(), other non real-time output to the port is held back
+    // until the message is ended. Received messages are passed on in chunks from the engine task.
+    bool sendSysEx(MidiPort port, const uint8_t *data, size_t length);
+    bool beginSysEx(MidiPort port);
+    size_t appendSysEx(MidiPort port, const uint8_t *data, size_t length);
+    bool endSysEx(MidiPort port);
+    void setSysExReceiveHandler(SysExReceiveHandler handler) { _sysExReceiveHandler = handler; }
+
     void setUsbMidiConnectHandler(UsbMidiConnectHandler handler) { _usbMidiConnectHandler = handler; }
     void setUsbMidiDisconnectHandler(UsbMidiDisconnectHandler handler) { _usbMidiDisconnectHandler = handler; }
 
@@ -146,6 +191,11 @@ public:
     void setMessageHandler(MessageHandler handler);
 
     Stats stats() const;
+    // resets the update time statistics (on the next update)
+    void resetStats() { _requestStatsReset = 1; }
+
+    // log of received MIDI messages (excluding real-time messages)
+    const MidiLog &midiLog() const { return _midiLog; }
 
 private:
     // Clock::Listener
@@ -158,12 +208,19 @@ private:
     void updatePlayState(bool ticked);
     void updateOverrides();
 
+    void suspendProject();
+    void resumeProject();
+    void updateSuspended();
+    void processProjectSwitch();
+
     void usbMidiConnect(uint16_t vendorId, uint16_t productId);
     void usbMidiDisconnect();
 
     void receiveMidi();
-    void receiveMidi(MidiPort port, const MidiMessage &message);
-    void monitorMidi(const MidiMessage &message);
+    void updateCvGateToMidiVoices();
+    void receiveMidi(MidiPort port, const MidiMessage &message, uint32_t tick);
+    void monitorMidi(const MidiMessage &message, uint32_t tick);
+    void receiveSysEx(MidiPort port, const MidiParser::SysExChunk &chunk);
 
     void initClock();
     void updateClockSetup();
@@ -186,22 +243,59 @@ private:
 
     TrackEngineContainerArray _trackEngineContainers;
     TrackEngineArray _trackEngines;
+    MidiFileStreamArray _midiFileStreams;
 
     MidiOutputEngine _midiOutputEngine;
 
     RoutingEngine _routingEngine;
     MidiLearn _midiLearn;
     MidiReceiveHandler _midiReceiveHandler;
+    SysExReceiveHandler _sysExReceiveHandler;
+    uint32_t _sysExRxBytes = 0;
+    uint32_t _sysExTxBytes = 0;
     UsbMidiConnectHandler _usbMidiConnectHandler;
     UsbMidiDisconnectHandler _usbMidiDisconnectHandler;
 
     CvGateToMidiConverter _cvGateToMidiConverter;
+    Types::CvGateInput _cvGateInput = Types::CvGateInput::Off;
 
     // locking
     volatile uint32_t _requestLock = 0;
     volatile uint32_t _requestUnlock = 0;
     volatile uint32_t _locked = 0;
 
+    // project switching
+    enum class ProjectSwitchState : uint8_t {
+        Idle,
+        Requested,  // waiting for bar boundary
+        Suspended,  // waiting for file task to load the project
+        Loading,
+        Loaded,     // waiting for engine to resume
+        TimedOut,   // waiting for engine to resume
+    };
+
+    ProjectLoadHandler _projectLoadHandler;
+    ProjectSwitchResultHandler _projectSwitchResultHandler;
+    volatile uint8_t _projectSwitchState = uint8_t(ProjectSwitchState::Idle);
+    uint32_t _projectSuspendTicks = 0;
+    uint32_t _projectSwitchTime = 0;
+
+    // statistics
+    struct UpdateTime {
+        uint32_t count = 0;
+        uint32_t max = 0;
+        uint64_t total = 0;
+
+        void record(uint32_t duration) {
+            ++count;
+            total += duration;
+            max = std::max(max, duration);
+        }
+    };
+    UpdateTime _updateTime;
+    volatile uint32_t _requestStatsReset = 0;
+    MidiLog _midiLog;
+
     uint32_t _tick = 0;
 
     uint32_t _lastSystemTicks = 0;
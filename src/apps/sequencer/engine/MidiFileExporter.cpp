@@ -0,0 +1,505 @@
+#include "MidiFileExporter.h"
+
+#include "Groove.h"
+#include "SequenceState.h"
+#include "SequenceUtils.h"
+#include "SortedQueue.h"
+
+#include "model/Curve.h"
+#include "model/Scale.h"
+
+#include "core/fs/FileWriter.h"
+#include "core/math/Math.h"
+#include "core/midi/MidiFile.h"
+#include "core/midi/MidiMessage.h"
+#include "core/utils/Random.h"
+#include "core/utils/StringBuilder.h"
+
+#include <algorithm>
+
+#include <cmath>
+#include <cstring>
+
+static const char *ExportDirectory = "MIDI";
+
+// curve tracks are sampled at sequence resolution
+static constexpr uint32_t CurveSampleDivisor = CONFIG_PPQN / CONFIG_SEQUENCE_PPQN;
+
+// Writes the events of a track chunk. Without a file writer, only the length of the chunk is counted.
+class TrackWriter {
+public:
+    TrackWriter(fs::FileWriter *writer) :
+        _writer(writer)
+    {}
+
+    uint32_t length() const { return _length; }
+
+    void message(uint32_t tick, const MidiMessage &message) {
+        delta(tick);
+        write(message.raw(), message.length());
+    }
+
+    void meta(uint32_t tick, MidiFile::MetaType type, const void *data, size_t len) {
+        uint8_t header[2 + MidiFile::MaxVariableLength] = { MidiFile::MetaEvent, uint8_t(type) };
+        size_t headerLength = 2 + MidiFile::encodeVariableLength(&header[2], len);
+        delta(tick);
+        write(header, headerLength);
+        write(data, len);
+    }
+
+    void trackName(const char *name) {
+        meta(0, MidiFile::MetaType::TrackName, name, std::strlen(name));
+    }
+
+    void endOfTrack(uint32_t tick) {
+        meta(tick, MidiFile::MetaType::EndOfTrack, nullptr, 0);
+    }
+
+private:
+    void delta(uint32_t tick) {
+        uint8_t data[MidiFile::MaxVariableLength];
+        write(data, MidiFile::encodeVariableLength(data, tick - _tick));
+        _tick = tick;
+    }
+
+    void write(const void *data, size_t len) {
+        if (_writer && len > 0) {
+            _writer->write(data, len);
+        }
+        _length += len;
+    }
+
+    fs::FileWriter *_writer;
+    uint32_t _tick = 0;
+    uint32_t _length = 0;
+};
+
+// Routable parameters are sampled once before rendering, so both passes render the same events.
+struct Parameters {
+    struct TrackParameters {
+        int rotate;
+        int octave;
+        int transpose;
+        int gateProbabilityBias;
+        int retriggerProbabilityBias;
+        int lengthBias;
+    };
+
+    float tempo;
+    int swing;
+    TrackParameters tracks[CONFIG_TRACK_COUNT];
+};
+
+static Parameters sampleParameters(const Project &project) {
+    Parameters parameters;
+    parameters.tempo = project.tempo();
+    parameters.swing = project.swing();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &track = project.track(trackIndex);
+        auto &trackParameters = parameters.tracks[trackIndex];
+        trackParameters = {};
+        switch (track.trackMode()) {
+        case Track::TrackMode::Note: {
+            const auto &noteTrack = track.noteTrack();
+            trackParameters.rotate = noteTrack.rotate();
+            trackParameters.octave = noteTrack.octave();
+            trackParameters.transpose = noteTrack.transpose();
+            trackParameters.gateProbabilityBias = noteTrack.gateProbabilityBias();
+            trackParameters.retriggerProbabilityBias = noteTrack.retriggerProbabilityBias();
+            trackParameters.lengthBias = noteTrack.lengthBias();
+            break;
+        }
+        case Track::TrackMode::Curve:
+            trackParameters.rotate = track.curveTrack().rotate();
+            break;
+        case Track::TrackMode::MidiCv:
+        case Track::TrackMode::MidiFile:
+        case Track::TrackMode::Last:
+            break;
+        }
+    }
+    return parameters;
+}
+
+// Segments played one after another, either a single pattern or the slots of the song.
+struct Arrangement {
+    const Project &project;
+    bool song;
+    int pattern;
+    int bars;
+    Parameters parameters;
+
+    uint32_t measureDivisor() const {
+        return project.timeSignature().measureDivisor();
+    }
+
+    int segmentCount() const {
+        return song ? project.song().slotCount() : 1;
+    }
+
+    int segmentPattern(int segment, int trackIndex) const {
+        return song ? project.song().slot(segment).pattern(trackIndex) : pattern;
+    }
+
+    uint32_t segmentLength(int segment) const {
+        return (song ? project.song().slot(segment).repeats() : bars) * measureDivisor();
+    }
+
+    uint32_t length() const {
+        uint32_t length = 0;
+        for (int segment = 0; segment < segmentCount(); ++segment) {
+            length += segmentLength(segment);
+        }
+        return length;
+    }
+};
+
+// resolve a probability to its more likely outcome
+static bool evalProbability(int probability, int range) {
+    return 2 * (probability + 1) >= range;
+}
+
+static uint32_t applySwing(const Arrangement &arrangement, uint32_t tick) {
+    return Groove::swing(tick, CONFIG_PPQN / 4, arrangement.parameters.swing);
+}
+
+template<typename Sequence>
+static uint32_t sequenceLength(const Sequence &sequence) {
+    return uint32_t(sequence.lastStep() - sequence.firstStep() + 1) * sequence.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
+}
+
+// Steps through the segments of an arrangement the same way the track engines advance
+// their sequences and calls the trigger callback for every step and the output callback
+// for every tick.
+template<typename TrackType, typename Trigger, typename Output>
+static uint32_t playSegments(const Arrangement &arrangement, int trackIndex, const TrackType &track, Trigger trigger, Output output) {
+    Random rng;
+    SequenceState sequenceState;
+    uint32_t measureDivisor = arrangement.measureDivisor();
+    uint32_t segmentStart = 0;
+
+    for (int segment = 0; segment < arrangement.segmentCount(); ++segment) {
+        const auto &segmentSequence = track.sequence(arrangement.segmentPattern(segment, trackIndex));
+        uint32_t divisor = segmentSequence.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
+        uint32_t resetDivisor = segmentSequence.resetMeasure() * measureDivisor;
+        uint32_t segmentEnd = segmentStart + arrangement.segmentLength(segment);
+        uint32_t freeRelativeTick = 0;
+
+        // tracks are restarted when the song advances to the next slot
+        sequenceState.reset();
+
+        for (uint32_t tick = segmentStart; tick < segmentEnd; ++tick) {
+            uint32_t relativeTick = resetDivisor == 0 ? tick : tick % resetDivisor;
+
+            // handle reset measure
+            bool reset = relativeTick == 0;
+            if (reset) {
+                sequenceState.reset();
+                freeRelativeTick = 0;
+            }
+
+            switch (track.playMode()) {
+            case Types::PlayMode::Aligned:
+                if (relativeTick % divisor == 0) {
+                    sequenceState.advanceAligned(relativeTick / divisor, segmentSequence.runMode(), segmentSequence.firstStep(), segmentSequence.lastStep(), rng);
+                    trigger(segmentSequence, sequenceState, tick, divisor, reset);
+                }
+                break;
+            case Types::PlayMode::Free:
+                relativeTick = freeRelativeTick;
+                if (++freeRelativeTick >= divisor) {
+                    freeRelativeTick = 0;
+                }
+                if (relativeTick == 0) {
+                    sequenceState.advanceFree(segmentSequence.runMode(), segmentSequence.firstStep(), segmentSequence.lastStep(), rng);
+                    trigger(segmentSequence, sequenceState, tick, divisor, reset);
+                }
+                break;
+            case Types::PlayMode::Last:
+                break;
+            }
+
+            output(segmentSequence, tick, relativeTick % divisor, divisor);
+        }
+
+        segmentStart = segmentEnd;
+    }
+
+    return segmentStart;
+}
+
+static void renderNoteTrack(const Arrangement &arrangement, int trackIndex, TrackWriter &writer) {
+    const auto &project = arrangement.project;
+    const auto &noteTrack = project.track(trackIndex).noteTrack();
+    const auto &parameters = arrangement.parameters.tracks[trackIndex];
+    uint8_t channel = trackIndex;
+
+    struct Gate {
+        uint32_t tick;
+        bool gate;
+    };
+
+    struct GateCompare {
+        bool operator()(const Gate &a, const Gate &b) {
+            return a.tick < b.tick;
+        }
+    };
+
+    struct Note {
+        uint32_t tick;
+        uint8_t note;
+    };
+
+    struct NoteCompare {
+        bool operator()(const Note &a, const Note &b) {
+            return a.tick < b.tick;
+        }
+    };
+
+    SortedQueue<Gate, 16, GateCompare> gateQueue;
+    SortedQueue<Note, 16, NoteCompare> noteQueue;
+    uint8_t currentNote = 60;
+    int activeNote = -1;
+
+    auto noteOff = [&] (uint32_t tick) {
+        if (activeNote >= 0) {
+            writer.message(tick, MidiMessage::makeNoteOff(channel, activeNote));
+            activeNote = -1;
+        }
+    };
+
+    auto trigger = [&] (const NoteSequence &sequence, const SequenceState &sequenceState, uint32_t tick, uint32_t divisor, bool reset) {
+        if (reset) {
+            noteOff(tick);
+            gateQueue.clear();
+            noteQueue.clear();
+        }
+
+        int currentStep = SequenceUtils::rotateStep(sequenceState.step(), sequence.firstStep(), sequence.lastStep(), parameters.rotate);
+        const auto &step = sequence.step(currentStep);
+
+        uint32_t gateOffset = (divisor * step.gateOffset()) / (NoteSequence::GateOffset::Max + 1);
+
+        int gateProbability = clamp(step.gateProbability() + parameters.gateProbabilityBias, -1, NoteSequence::GateProbability::Max);
+        bool stepGate = step.gate() && evalProbability(gateProbability, NoteSequence::GateProbability::Range);
+
+        if (stepGate) {
+            uint32_t stepLength = (divisor * (NoteSequence::Length::clamp(step.length() + parameters.lengthBias) + 1)) / NoteSequence::Length::Range;
+            int retriggerProbability = clamp(step.retriggerProbability() + parameters.retriggerProbabilityBias, -1, NoteSequence::RetriggerProbability::Max);
+            int stepRetrigger = evalProbability(retriggerProbability, NoteSequence::RetriggerProbability::Range) ? step.retrigger() + 1 : 1;
+            if (stepRetrigger > 1) {
+                uint32_t retriggerLength = divisor / stepRetrigger;
+                uint32_t retriggerOffset = 0;
+                while (stepRetrigger-- > 0 && retriggerOffset <= stepLength) {
+                    gateQueue.pushReplace({ applySwing(arrangement, tick + gateOffset + retriggerOffset), true });
+                    gateQueue.pushReplace({ applySwing(arrangement, tick + gateOffset + retriggerOffset + retriggerLength / 2), false });
+                    retriggerOffset += retriggerLength;
+                }
+            } else {
+                gateQueue.pushReplace({ applySwing(arrangement, tick + gateOffset), true });
+                gateQueue.pushReplace({ applySwing(arrangement, tick + gateOffset + stepLength), false });
+            }
+
+            const auto &scale = sequence.selectedScale(project.scale());
+            int rootNote = sequence.selectedRootNote(project.rootNote());
+            int note = step.note() + (scale.isChromatic() ? rootNote : 0) + parameters.octave * scale.notesPerOctave() + parameters.transpose;
+            float cv = scale.noteToVolts(note);
+            noteQueue.push({ applySwing(arrangement, tick + gateOffset), uint8_t(clamp(60 + int(std::floor(cv * 12.f + 0.01f)), 0, 127)) });
+        }
+    };
+
+    auto output = [&] (const NoteSequence &sequence, uint32_t tick, uint32_t stepTick, uint32_t divisor) {
+        // note changes take effect before gates scheduled for the same tick
+        while (!noteQueue.empty() && tick >= noteQueue.front().tick) {
+            currentNote = noteQueue.front().note;
+            noteQueue.pop();
+        }
+        while (!gateQueue.empty() && tick >= gateQueue.front().tick) {
+            bool gate = gateQueue.front().gate;
+            gateQueue.pop();
+            noteOff(tick);
+            if (gate) {
+                writer.message(tick, MidiMessage::makeNoteOn(channel, currentNote));
+                activeNote = currentNote;
+            }
+        }
+    };
+
+    uint32_t end = playSegments(arrangement, trackIndex, noteTrack, trigger, output);
+
+    noteOff(end);
+}
+
+static void renderCurveTrack(const Arrangement &arrangement, int trackIndex, TrackWriter &writer) {
+    const auto &project = arrangement.project;
+    const auto &curveTrack = project.track(trackIndex).curveTrack();
+    const auto &parameters = arrangement.parameters.tracks[trackIndex];
+    uint8_t channel = trackIndex;
+
+    int currentStep = -1;
+    int lastValue = -1;
+
+    auto trigger = [&] (const CurveSequence &sequence, const SequenceState &sequenceState, uint32_t tick, uint32_t divisor, bool reset) {
+        currentStep = SequenceUtils::rotateStep(sequenceState.step(), sequence.firstStep(), sequence.lastStep(), parameters.rotate);
+    };
+
+    auto output = [&] (const CurveSequence &sequence, uint32_t tick, uint32_t stepTick, uint32_t divisor) {
+        if (currentStep < 0 || tick % CurveSampleDivisor != 0) {
+            return;
+        }
+
+        const auto &step = sequence.step(currentStep);
+        float value = Curve::function(Curve::Type(step.shape()))(float(stepTick) / divisor);
+        float min = float(step.min()) / CurveSequence::Min::Max;
+        float max = float(step.max()) / CurveSequence::Max::Max;
+        value = min + value * (max - min);
+
+        int controlValue = clamp(int(std::round(value * 127.f)), 0, 127);
+        if (controlValue != lastValue) {
+            writer.message(tick, MidiMessage::makeControlChange(channel, MidiFileExporter::CurveControlNumber, controlValue));
+            lastValue = controlValue;
+        }
+    };
+
+    playSegments(arrangement, trackIndex, curveTrack, trigger, output);
+}
+
+static void renderConductorTrack(const Arrangement &arrangement, TrackWriter &writer) {
+    const auto &project = arrangement.project;
+    auto timeSignature = project.timeSignature();
+
+    writer.trackName(project.name());
+
+    uint8_t tempo[3];
+    uint32_t microsPerQuarter = uint32_t(60000000.f / arrangement.parameters.tempo + 0.5f);
+    tempo[0] = microsPerQuarter >> 16;
+    tempo[1] = microsPerQuarter >> 8;
+    tempo[2] = microsPerQuarter;
+    writer.meta(0, MidiFile::MetaType::Tempo, tempo, sizeof(tempo));
+
+    uint8_t signature[4] = { uint8_t(timeSignature.beats()), 0, 24, 8 };
+    for (int note = timeSignature.note(); note > 1; note >>= 1) {
+        ++signature[1];
+    }
+    writer.meta(0, MidiFile::MetaType::TimeSignature, signature, sizeof(signature));
+}
+
+static void renderTrack(const Arrangement &arrangement, int trackIndex, TrackWriter &writer) {
+    if (trackIndex < 0) {
+        renderConductorTrack(arrangement, writer);
+    } else {
+        writer.trackName(FixedStringBuilder<8>("TRACK%d", trackIndex + 1));
+        switch (arrangement.project.track(trackIndex).trackMode()) {
+        case Track::TrackMode::Note:
+            renderNoteTrack(arrangement, trackIndex, writer);
+            break;
+        case Track::TrackMode::Curve:
+            renderCurveTrack(arrangement, trackIndex, writer);
+            break;
+        case Track::TrackMode::MidiCv:
+        case Track::TrackMode::MidiFile:
+        case Track::TrackMode::Last:
+            break;
+        }
+    }
+    writer.endOfTrack(arrangement.length());
+}
+
+static fs::Error writeFile(const Arrangement &arrangement, const char *path) {
+    fs::FileWriter fileWriter(path);
+    if (fileWriter.error() != fs::OK) {
+        return fileWriter.error();
+    }
+
+    uint8_t header[MidiFile::ChunkHeaderSize + MidiFile::HeaderChunkLength];
+    MidiFile::encodeChunkHeader(header, "MThd", MidiFile::HeaderChunkLength);
+    MidiFile::encodeUint16(&header[8], uint16_t(MidiFile::Format::MultiTrack));
+    MidiFile::encodeUint16(&header[10], CONFIG_TRACK_COUNT + 1);
+    MidiFile::encodeUint16(&header[12], MidiFileExporter::Division);
+    fileWriter.write(header, sizeof(header));
+
+    // conductor track followed by sequencer tracks
+    for (int trackIndex = -1; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        // first pass determines the chunk length
+        TrackWriter counter(nullptr);
+        renderTrack(arrangement, trackIndex, counter);
+
+        uint8_t chunkHeader[MidiFile::ChunkHeaderSize];
+        MidiFile::encodeChunkHeader(chunkHeader, "MTrk", counter.length());
+        fileWriter.write(chunkHeader, sizeof(chunkHeader));
+
+        // second pass streams the events
+        TrackWriter writer(&fileWriter);
+        renderTrack(arrangement, trackIndex, writer);
+
+        if (fileWriter.error() != fs::OK) {
+            break;
+        }
+
+        // sequences edited while exporting can still change the rendered events
+        if (writer.length() != counter.length()) {
+            fileWriter.finish();
+            return fs::INT_ERR;
+        }
+    }
+
+    return fileWriter.finish();
+}
+
+static fs::Error prepareExportDirectory() {
+    if (!fs::exists(ExportDirectory)) {
+        return fs::mkdir(ExportDirectory);
+    }
+    return fs::OK;
+}
+
+fs::Error MidiFileExporter::exportPattern(const Project &project, int pattern) {
+    auto result = prepareExportDirectory();
+    if (result != fs::OK) {
+        return result;
+    }
+    FixedStringBuilder<32> path("%s/PAT%02d.MID", ExportDirectory, pattern + 1);
+    return exportPattern(project, pattern, patternBars(project, pattern), path);
+}
+
+fs::Error MidiFileExporter::exportSong(const Project &project) {
+    auto result = prepareExportDirectory();
+    if (result != fs::OK) {
+        return result;
+    }
+    FixedStringBuilder<32> path("%s/SONG.MID", ExportDirectory);
+    return exportSong(project, path);
+}
+
+fs::Error MidiFileExporter::exportPattern(const Project &project, int pattern, int bars, const char *path) {
+    Arrangement arrangement = { project, false, clamp(pattern, 0, CONFIG_PATTERN_COUNT - 1), clamp(bars, 1, MaxPatternBars), sampleParameters(project) };
+    return writeFile(arrangement, path);
+}
+
+fs::Error MidiFileExporter::exportSong(const Project &project, const char *path) {
+    Arrangement arrangement = { project, true, 0, 0, sampleParameters(project) };
+    return writeFile(arrangement, path);
+}
+
+int MidiFileExporter::patternBars(const Project &project, int pattern) {
+    uint32_t length = 0;
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &track = project.track(trackIndex);
+        switch (track.trackMode()) {
+        case Track::TrackMode::Note:
+            length = std::max(length, sequenceLength(track.noteTrack().sequence(pattern)));
+            break;
+        case Track::TrackMode::Curve:
+            length = std::max(length, sequenceLength(track.curveTrack().sequence(pattern)));
+            break;
+        case Track::TrackMode::MidiCv:
+        case Track::TrackMode::MidiFile:
+        case Track::TrackMode::Last:
+            break;
+        }
+    }
+
+    uint32_t measureDivisor = project.timeSignature().measureDivisor();
+    return clamp(int((length + measureDivisor - 1) / measureDivisor), 1, MaxPatternBars);
+}
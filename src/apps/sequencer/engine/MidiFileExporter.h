@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Config.h"
+
+#include "model/Project.h"
+
+#include "core/fs/FileSystem.h"
+
+#include <cstdint>
+
+// Renders note and curve sequences into a Type-1 Standard MIDI File.
+// The first track holds tempo and time signature, followed by one track per
+// sequencer track using the track index as MIDI channel. Note tracks are
+// exported as notes, curve tracks as control changes. Every track is rendered
+// twice, once to determine the chunk length and once to stream it to the file,
+// so memory use does not depend on the length of the export. Routable parameters
+// are sampled once before rendering, an export whose passes still differ (sequence
+// edited while exporting) fails with fs::INT_ERR.
+// Rendering is deterministic: probabilities are resolved to their more likely
+// outcome, variations, conditions, fills and mutes are ignored.
+class MidiFileExporter {
+public:
+    static constexpr uint16_t Division = CONFIG_PPQN;
+    static constexpr uint8_t CurveControlNumber = 1;
+    static constexpr int MaxPatternBars = 64;
+
+    // exports a pattern of all tracks to MIDI/PATnn.MID
+    static fs::Error exportPattern(const Project &project, int pattern);
+    // exports the song chain to MIDI/SONG.MID
+    static fs::Error exportSong(const Project &project);
+
+    // exports a pattern of all tracks for the given number of bars
+    static fs::Error exportPattern(const Project &project, int pattern, int bars, const char *path);
+    // exports the song chain, each slot is played for its number of repeats (in bars)
+    static fs::Error exportSong(const Project &project, const char *path);
+
+    // returns the number of bars until the longest sequence of a pattern has played once
+    static int patternBars(const Project &project, int pattern);
+};
@@ -0,0 +1,272 @@
+#include "MidiFileStream.h"
+
+#include "core/fs/File.h"
+#include "core/midi/MidiFile.h"
+#include "core/utils/StringBuilder.h"
+
+#include <algorithm>
+
+// limit the amount of data parsed in one go to not block the file task on files with lots of skipped events
+static constexpr int MaxBlocksPerProcess = 8;
+
+static void filePath(StringBuilder &str, int file) {
+    str("MIDI/%03d.MID", file);
+}
+
+static fs::Error readBlock(fs::File &file, uint32_t offset, uint8_t *data, size_t len) {
+    size_t lenRead;
+    if (file.seek(offset) != fs::OK || file.read(data, len, &lenRead) != fs::OK) {
+        return file.error();
+    }
+    return lenRead == len ? fs::OK : fs::END_OF_FILE;
+}
+
+void MidiFileStream::open(int file, int fileTrack, bool loop, uint32_t loopDivisor) {
+    _request.file = file;
+    _request.fileTrack = fileTrack;
+    _request.loop = loop;
+    _request.loopDivisor = loopDivisor;
+    _requestCounter = _requestCounter + 1;
+}
+
+void MidiFileStream::close() {
+    _request.file = 0;
+    _requestCounter = _requestCounter + 1;
+}
+
+bool MidiFileStream::read(Event &event) {
+    uint8_t generation = _requestCounter;
+    while (!_events.empty()) {
+        event = _events.read();
+        // drop events parsed for a previous request
+        if (event.generation == generation) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MidiFileStream::process() {
+    uint32_t requestCounter = _requestCounter;
+    if (requestCounter != _handledCounter) {
+        Request request = _request;
+        // request was changed by the engine while copying, handle it on the next call
+        if (requestCounter != _requestCounter) {
+            return;
+        }
+        _handledCounter = requestCounter;
+        _generation = requestCounter;
+        start(request);
+    }
+
+    if (State(_state) == State::Streaming) {
+        fill();
+    }
+}
+
+void MidiFileStream::start(const Request &request) {
+    _current = request;
+
+    if (request.file == 0) {
+        setState(State::Idle);
+        return;
+    }
+
+    FixedStringBuilder<16> path;
+    filePath(path, request.file);
+    fs::File file(path, fs::File::Read);
+    if (file.error() != fs::OK) {
+        setState(State::Error, file.error());
+        return;
+    }
+
+    uint8_t header[MidiFile::ChunkHeaderSize + MidiFile::HeaderChunkLength];
+    auto error = readBlock(file, 0, header, sizeof(header));
+    if (error != fs::OK) {
+        setState(State::Error, error);
+        return;
+    }
+
+    uint32_t headerLength = MidiFile::decodeUint32(&header[4]);
+    _division = MidiFile::decodeUint16(&header[12]);
+    // SMPTE based time division is not supported
+    if (!MidiFile::isChunk(header, "MThd") || headerLength < MidiFile::HeaderChunkLength || _division == 0 || (_division & 0x8000)) {
+        setState(State::Error, fs::INVALID_CHECKSUM);
+        return;
+    }
+
+    // find the requested track chunk, unknown chunks are skipped
+    uint32_t offset = MidiFile::ChunkHeaderSize + headerLength;
+    int trackIndex = 0;
+    while (true) {
+        uint8_t chunk[MidiFile::ChunkHeaderSize];
+        error = readBlock(file, offset, chunk, sizeof(chunk));
+        if (error != fs::OK) {
+            setState(State::Error, error);
+            return;
+        }
+        uint32_t length = MidiFile::decodeUint32(&chunk[4]);
+        if (MidiFile::isChunk(chunk, "MTrk")) {
+            if (trackIndex == request.fileTrack) {
+                _chunkStart = offset + MidiFile::ChunkHeaderSize;
+                _chunkEnd = _chunkStart + length;
+                break;
+            }
+            ++trackIndex;
+        }
+        offset += MidiFile::ChunkHeaderSize + length;
+    }
+
+    _offset = _chunkStart;
+    _fileTick = 0;
+    _tickOffset = 0;
+    _runningStatus = 0;
+    setState(State::Streaming);
+}
+
+void MidiFileStream::fill() {
+    // refill when at least half of the buffer is free
+    // the file is opened for each refill as only few files can be open at the same time
+    if (_events.writable() < _events.size() / 2) {
+        return;
+    }
+
+    FixedStringBuilder<16> path;
+    filePath(path, _current.file);
+    fs::File file(path, fs::File::Read);
+    if (file.error() != fs::OK) {
+        setState(State::Error, file.error());
+        return;
+    }
+
+    for (int block = 0; block < MaxBlocksPerProcess && State(_state) == State::Streaming && _events.writable() > 0; ++block) {
+        size_t len = _offset < _chunkEnd ? std::min<size_t>(BlockSize, _chunkEnd - _offset) : 0;
+        if (len == 0) {
+            // track chunk without end of track event
+            endOfTrack();
+            continue;
+        }
+
+        uint8_t data[BlockSize];
+        auto error = readBlock(file, _offset, data, len);
+        if (error != fs::OK) {
+            setState(State::Error, error);
+            return;
+        }
+
+        // a block that does not contain a single complete event is malformed
+        if (!parse(data, len) && State(_state) == State::Streaming) {
+            setState(State::Error, fs::INVALID_CHECKSUM);
+        }
+    }
+}
+
+bool MidiFileStream::parse(const uint8_t *data, size_t len) {
+    bool progress = false;
+    size_t pos = 0;
+
+    while (pos < len && _events.writable() > 0) {
+        size_t p = pos;
+
+        uint32_t delta;
+        size_t n = MidiFile::decodeVariableLength(&data[p], len - p, delta);
+        if (n == 0 || (p += n) >= len) {
+            break;
+        }
+
+        uint8_t status = data[p];
+        if (status & 0x80) {
+            ++p;
+        } else if (_runningStatus) {
+            status = _runningStatus;
+        } else {
+            setState(State::Error, fs::INVALID_CHECKSUM);
+            return true;
+        }
+
+        if (status == MidiFile::MetaEvent || status == MidiFile::SysExEvent || status == MidiFile::SysExEscapeEvent) {
+            uint8_t type = 0;
+            if (status == MidiFile::MetaEvent) {
+                if (p >= len) {
+                    break;
+                }
+                type = data[p++];
+            }
+            uint32_t length;
+            n = MidiFile::decodeVariableLength(&data[p], len - p, length);
+            if (n == 0) {
+                break;
+            }
+            // meta and sysex events cancel running status, their payload is skipped
+            _runningStatus = 0;
+            _fileTick += delta;
+            _offset += p + n + length - pos;
+            pos = p + n + length;
+            progress = true;
+
+            if (status == MidiFile::MetaEvent && type == uint8_t(MidiFile::MetaType::EndOfTrack)) {
+                endOfTrack();
+                // offset was moved, remaining data is stale
+                return true;
+            }
+        } else if (status >= 0xf0) {
+            setState(State::Error, fs::INVALID_CHECKSUM);
+            return true;
+        } else {
+            size_t length = MidiFile::channelMessageLength(status);
+            if (p + length > len) {
+                break;
+            }
+            _runningStatus = status;
+            _fileTick += delta;
+            uint8_t type = status & 0xf0;
+            if (type == 0x80 || type == 0x90) {
+                push(fileTickToTick(_fileTick), status, data[p] & 0x7f, data[p + 1] & 0x7f);
+            }
+            _offset += p + length - pos;
+            pos = p + length;
+            progress = true;
+        }
+    }
+
+    return progress;
+}
+
+void MidiFileStream::endOfTrack() {
+    uint32_t length = fileTickToTick(_fileTick) - _tickOffset;
+    push(_tickOffset + length, EndOfTrack, 0, 0);
+
+    if (_current.loop && _current.loopDivisor > 0) {
+        length = ((length + _current.loopDivisor - 1) / _current.loopDivisor) * _current.loopDivisor;
+    }
+
+    // an empty track is not looped
+    if (!_current.loop || length == 0) {
+        setState(State::Finished);
+        return;
+    }
+
+    _tickOffset += length;
+    _offset = _chunkStart;
+    _fileTick = 0;
+    _runningStatus = 0;
+}
+
+uint32_t MidiFileStream::fileTickToTick(uint32_t fileTick) const {
+    return _tickOffset + uint32_t((uint64_t(fileTick) * CONFIG_PPQN) / _division);
+}
+
+void MidiFileStream::push(uint32_t tick, uint8_t status, uint8_t note, uint8_t velocity) {
+    Event event;
+    event.tick = tick;
+    event.generation = _generation;
+    event.status = status;
+    event.note = note;
+    event.velocity = velocity;
+    _events.write(event);
+}
+
+void MidiFileStream::setState(State state, fs::Error error) {
+    _error = error;
+    _state = uint8_t(state);
+}
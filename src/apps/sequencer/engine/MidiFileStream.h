@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Config.h"
+
+#include "core/fs/Error.h"
+#include "core/utils/RingBuffer.h"
+
+#include <cstdint>
+
+// Streams note events of a single track of a Standard MIDI File from the sd card.
+// The engine requests a file (open/close) and consumes events (read) while the file task
+// parses the file in small blocks (process) and keeps the event buffer filled.
+// Requests are handed over through a request counter, every event is tagged with the
+// generation of the request it was parsed for, so stale events can be dropped by the engine.
+class MidiFileStream {
+public:
+    struct Event {
+        uint32_t tick;          // sequencer ticks since the stream was opened
+        uint8_t generation;
+        uint8_t status;         // note on/off status byte or EndOfTrack
+        uint8_t note;
+        uint8_t velocity;
+
+        bool isEndOfTrack() const { return status == EndOfTrack; }
+    };
+
+    enum class State : uint8_t {
+        Idle,
+        Streaming,
+        Finished,
+        Error,
+    };
+
+    static constexpr uint8_t EndOfTrack = 0xff;
+
+    // Engine interface
+
+    // opens track fileTrack of MIDI/<file>.MID, the loop length is rounded up to a multiple of loopDivisor
+    void open(int file, int fileTrack, bool loop, uint32_t loopDivisor);
+    void close();
+
+    // reads the next event of the current request, returns false if no event is buffered
+    bool read(Event &event);
+
+    State state() const { return State(_state); }
+    fs::Error error() const { return fs::Error(_error); }
+
+    // File task interface
+
+    void process();
+
+private:
+    static constexpr size_t BlockSize = 64;
+
+    struct Request {
+        uint16_t file = 0;
+        uint8_t fileTrack = 0;
+        bool loop = false;
+        uint32_t loopDivisor = 0;
+    };
+
+    void start(const Request &request);
+    void fill();
+    bool parse(const uint8_t *data, size_t len);
+    void endOfTrack();
+    uint32_t fileTickToTick(uint32_t fileTick) const;
+    void push(uint32_t tick, uint8_t status, uint8_t note, uint8_t velocity);
+    void setState(State state, fs::Error error = fs::OK);
+
+    // shared
+    RingBuffer<Event, CONFIG_MIDI_FILE_STREAM_SIZE> _events;
+    Request _request;
+    volatile uint32_t _requestCounter = 0;
+    volatile uint8_t _state = uint8_t(State::Idle);
+    volatile uint8_t _error = fs::OK;
+
+    // file task
+    Request _current;
+    uint32_t _handledCounter = 0;
+    uint8_t _generation = 0;
+    uint16_t _division;
+    uint32_t _chunkStart;
+    uint32_t _chunkEnd;
+    uint32_t _offset;
+    uint32_t _fileTick;
+    uint32_t _tickOffset;
+    uint8_t _runningStatus;
+};
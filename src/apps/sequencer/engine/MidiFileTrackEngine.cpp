@@ -0,0 +1,150 @@
+#include "MidiFileTrackEngine.h"
+#include "Engine.h"
+
+#include <algorithm>
+
+void MidiFileTrackEngine::reset() {
+    releaseNotes();
+    _cvOutput = 0.f;
+
+    // keep events buffered by the file task unless they were already played
+    if (_consumed || streamChanged()) {
+        openStream();
+    }
+
+    _started = false;
+}
+
+void MidiFileTrackEngine::restart() {
+    // the file plays continuously and is not restarted by song slots
+}
+
+void MidiFileTrackEngine::tick(uint32_t tick) {
+    if (!_started) {
+        _startTick = tick;
+        _started = true;
+    }
+
+    uint32_t relativeTick = tick - _startTick;
+    auto &midiFileStream = stream();
+
+    while (true) {
+        if (!_eventPending) {
+            if (!midiFileStream.read(_event)) {
+                break;
+            }
+            _eventPending = true;
+            _consumed = true;
+        }
+        if (_event.tick > relativeTick) {
+            break;
+        }
+        _eventPending = false;
+        handleEvent(_event);
+    }
+}
+
+void MidiFileTrackEngine::update(float dt) {
+    // restart playback when a different file/track is selected
+    if (streamChanged()) {
+        releaseNotes();
+        openStream();
+        _started = false;
+    }
+
+    if (!_engine.clockRunning() && _noteCount > 0) {
+        releaseNotes();
+    }
+}
+
+bool MidiFileTrackEngine::activity() const {
+    return _activity;
+}
+
+bool MidiFileTrackEngine::gateOutput(int index) const {
+    return !mute() && _activity;
+}
+
+float MidiFileTrackEngine::cvOutput(int index) const {
+    return _cvOutput;
+}
+
+MidiFileStream &MidiFileTrackEngine::stream() {
+    return _engine.midiFileStream(_track.trackIndex());
+}
+
+void MidiFileTrackEngine::openStream() {
+    _file = _midiFileTrack.file();
+    _fileTrack = _midiFileTrack.fileTrack();
+    _loop = _midiFileTrack.loop();
+    _loopDivisor = _engine.measureDivisor();
+    _consumed = false;
+    _eventPending = false;
+
+    stream().open(_file, _fileTrack, _loop, _loopDivisor);
+}
+
+bool MidiFileTrackEngine::streamChanged() const {
+    return _file != _midiFileTrack.file() ||
+        _fileTrack != _midiFileTrack.fileTrack() ||
+        _loop != _midiFileTrack.loop() ||
+        (_loop && _loopDivisor != _engine.measureDivisor());
+}
+
+void MidiFileTrackEngine::handleEvent(const MidiFileStream::Event &event) {
+    if (event.isEndOfTrack()) {
+        releaseNotes();
+        return;
+    }
+
+    int channel = _midiFileTrack.channel();
+    if (channel != -1 && (event.status & 0x0f) != channel) {
+        return;
+    }
+
+    if ((event.status & 0xf0) == 0x90 && event.velocity > 0) {
+        noteOn(event.note);
+    } else {
+        noteOff(event.note);
+    }
+}
+
+void MidiFileTrackEngine::noteOn(int note) {
+    noteOff(note);
+    // drop the oldest note if too many notes are held
+    if (_noteCount == MaxNotes) {
+        std::copy(_notes.begin() + 1, _notes.end(), _notes.begin());
+        --_noteCount;
+    }
+    _notes[_noteCount++] = note;
+    updateOutput();
+}
+
+void MidiFileTrackEngine::noteOff(int note) {
+    auto end = _notes.begin() + _noteCount;
+    auto it = std::remove(_notes.begin(), end, note);
+    if (it != end) {
+        _noteCount = it - _notes.begin();
+        updateOutput();
+    }
+}
+
+void MidiFileTrackEngine::releaseNotes() {
+    _noteCount = 0;
+    updateOutput();
+}
+
+void MidiFileTrackEngine::updateOutput() {
+    bool activity = _noteCount > 0;
+    if (activity) {
+        float cvOutput = (_notes[_noteCount - 1] - 60) * (1.f / 12.f);
+        if (cvOutput != _cvOutput) {
+            _cvOutput = cvOutput;
+            _engine.midiOutputEngine().sendCv(_track.trackIndex(), _cvOutput);
+        }
+    }
+    if (activity != _activity) {
+        _activity = activity;
+        _engine.midiOutputEngine().sendGate(_track.trackIndex(), !mute() && _activity);
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "TrackEngine.h"
+#include "MidiFileStream.h"
+
+#include "model/Track.h"
+
+#include <array>
+
+class MidiFileTrackEngine : public TrackEngine {
+public:
+    MidiFileTrackEngine(Engine &engine, const Model &model, Track &track, const TrackEngine *linkedTrackEngine) :
+        TrackEngine(engine, model, track, linkedTrackEngine),
+        _midiFileTrack(track.midiFileTrack())
+    {
+        _noteCount = 0;
+        _activity = false;
+        _consumed = true;
+        reset();
+    }
+
+    virtual Track::TrackMode trackMode() const override { return Track::TrackMode::MidiFile; }
+
+    virtual void reset() override;
+    virtual void restart() override;
+    virtual void tick(uint32_t tick) override;
+    virtual void update(float dt) override;
+
+    virtual bool activity() const override;
+    virtual bool gateOutput(int index) const override;
+    virtual float cvOutput(int index) const override;
+
+private:
+    static constexpr size_t MaxNotes = 8;
+
+    MidiFileStream &stream();
+    void openStream();
+    bool streamChanged() const;
+
+    void handleEvent(const MidiFileStream::Event &event);
+
+    void noteOn(int note);
+    void noteOff(int note);
+    void releaseNotes();
+    void updateOutput();
+
+    const MidiFileTrack &_midiFileTrack;
+
+    // opened stream
+    uint16_t _file;
+    uint8_t _fileTrack;
+    bool _loop;
+    uint32_t _loopDivisor;
+    bool _consumed;
+
+    bool _started;
+    uint32_t _startTick;
+    MidiFileStream::Event _event;
+    bool _eventPending;
+
+    // held notes, last note has priority
+    std::array<uint8_t, MaxNotes> _notes;
+    uint8_t _noteCount;
+
+    bool _activity;
+    float _cvOutput;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MidiPort.h"
+
+#include "core/midi/MidiMessage.h"
+
+#include <array>
+
+#include <cstddef>
+#include <cstdint>
+
+// Capture ring of received MIDI messages used for monitoring.
+// The engine writes without blocking and overwrites the oldest entries. Readers access entries by
+// their sequence index and detect entries that were overwritten while being copied.
+class MidiLog {
+public:
+    static constexpr size_t Size = 64;
+
+    struct Entry {
+        uint32_t tick;
+        MidiPort port;
+        MidiMessage message;
+    };
+
+    // Engine interface
+
+    void write(uint32_t tick, MidiPort port, const MidiMessage &message) {
+        uint32_t index = _writeIndex;
+        auto &entry = _entries[index % Size];
+        entry.tick = tick;
+        entry.port = port;
+        entry.message = message;
+        _writeIndex = index + 1;
+    }
+
+    // UI interface
+
+    // number of entries written so far, the most recent entry has the index writeIndex() - 1
+    uint32_t writeIndex() const { return _writeIndex; }
+
+    // reads the entry with the given sequence index, returns false if it is not available (anymore)
+    bool read(uint32_t index, Entry &entry) const {
+        if (!isAvailable(index)) {
+            return false;
+        }
+        entry = _entries[index % Size];
+        return isAvailable(index);
+    }
+
+private:
+    // the slot of the entry currently being written is never available
+    bool isAvailable(uint32_t index) const {
+        uint32_t writeIndex = _writeIndex;
+        uint32_t age = writeIndex - index;
+        return age >= 1 && age <= writeIndex && age < Size;
+    }
+
+    std::array<Entry, Size> _entries;
+    volatile uint32_t _writeIndex = 0;
+};
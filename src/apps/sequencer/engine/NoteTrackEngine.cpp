@@ -334,35 +334,58 @@ void NoteTrackEngine::recordStep(uint32_t tick, uint32_t divisor) {
         step.clear();
     };
 
+    // notes are quantized to the nearest (swung) step start, the quantization window of the
+    // recorded step therefore spans from halfway to the previous step to halfway to the next step
+    auto windowBoundary = [this, divisor] (uint32_t stepStart) {
+        if (stepStart < divisor) {
+            return stepStart;
+        }
+        return std::min(stepStart, (applySwing(stepStart - divisor) + applySwing(stepStart)) / 2);
+    };
+
     uint32_t stepStart = tick - divisor;
     uint32_t stepEnd = tick;
-    uint32_t margin = divisor / 2;
+    uint32_t stepCenter = applySwing(stepStart);
+    uint32_t windowStart = windowBoundary(stepStart);
+    uint32_t windowEnd = windowBoundary(stepEnd);
 
-    for (size_t i = 0; i < _recordHistory.size(); ++i) {
-        if (_recordHistory[i].type != RecordHistory::Type::NoteOn) {
-            continue;
-        }
+    auto noteEnd = [this, tick] (int index) {
+        return index + 1 < int(_recordHistory.size()) ? _recordHistory[index + 1].tick : tick;
+    };
 
-        int note = _recordHistory[i].note;
-        uint32_t noteStart = _recordHistory[i].tick;
-        uint32_t noteEnd = i + 1 < _recordHistory.size() ? _recordHistory[i + 1].tick : tick;
-
-        if (noteStart >= stepStart - margin && noteStart < stepStart + margin) {
-            // note on during step start phase
-            if (noteEnd >= stepEnd) {
-                // note hold during step
-                int length = std::min(noteEnd, stepEnd) - stepStart;
-                writeStep(_sequenceState.prevStep(), note, length);
-            } else {
-                // note released during step
-                int length = noteEnd - noteStart;
-                writeStep(_sequenceState.prevStep(), note, length);
+    // scan history backwards, only the notes within (and just before) the window are visited
+    int quantizedIndex = -1;
+    uint32_t quantizedDistance = 0;
+    int heldIndex = -1;
+    for (int i = int(_recordHistory.size()) - 1; i >= 0; --i) {
+        const auto &event = _recordHistory[i];
+        if (event.tick < windowStart) {
+            // note on before the window and still active at the step start
+            if (event.type == RecordHistory::Type::NoteOn && noteEnd(i) > stepCenter) {
+                heldIndex = i;
             }
-        } else if (noteStart < stepStart && noteEnd > stepStart) {
-            // note on during previous step
-            int length = std::min(noteEnd, stepEnd) - stepStart;
-            writeStep(_sequenceState.prevStep(), note, length);
+            break;
+        }
+        if (event.type != RecordHistory::Type::NoteOn || event.tick >= windowEnd) {
+            continue;
         }
+        // use the note closest to the step start
+        uint32_t distance = event.tick > stepCenter ? event.tick - stepCenter : stepCenter - event.tick;
+        if (quantizedIndex == -1 || distance <= quantizedDistance) {
+            quantizedIndex = i;
+            quantizedDistance = distance;
+        }
+    }
+
+    if (quantizedIndex >= 0) {
+        // note on during step start phase
+        uint32_t noteStart = _recordHistory[quantizedIndex].tick;
+        int length = noteEnd(quantizedIndex) >= stepEnd ? divisor : noteEnd(quantizedIndex) - noteStart;
+        writeStep(_sequenceState.prevStep(), _recordHistory[quantizedIndex].note, length);
+    } else if (heldIndex >= 0) {
+        // note on during previous step
+        int length = std::min(noteEnd(heldIndex), stepEnd) - stepCenter;
+        writeStep(_sequenceState.prevStep(), _recordHistory[heldIndex].note, length);
     }
 
     if (isSelected() && !stepWritten && _model.project().recordMode() == Types::RecordMode::Overwrite) {
@@ -35,6 +35,10 @@ public:
         return _currentStep < 0 ? 0.f : float(_currentStep - _sequence->firstStep()) / (_sequence->lastStep() - _sequence->firstStep());
     }
 
+    virtual int gateQueueHighWater() const override { return _gateQueue.highWater(); }
+    virtual int cvQueueHighWater() const override { return _cvQueue.highWater(); }
+    virtual void resetQueueHighWater() override { _gateQueue.resetHighWater(); _cvQueue.resetHighWater(); }
+
     const NoteSequence &sequence() const { return *_sequence; }
     bool isActiveSequence(const NoteSequence &sequence) const { return &sequence == _sequence; }
 
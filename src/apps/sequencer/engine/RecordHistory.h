@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Config.h"
+
 #include "core/utils/RingBuffer.h"
 #include "core/midi/MidiMessage.h"
 
@@ -9,6 +11,12 @@
 #include <cstdint>
 #include <cinttypes>
 
+// Ring buffer of recently played notes with tick accurate timestamps. Notes are
+// recorded monophonic, each note on is followed by a note off (or is still
+// active). Notes are quantized to steps when a recorded step is committed to
+// the sequence (see NoteTrackEngine::recordStep), which only looks back one and
+// a half steps (plus the note held into the window). The history holds 16 notes,
+// enough for about 10 notes per step, older notes of the window are lost beyond.
 class RecordHistory {
 public:
     enum class Type : uint8_t {
@@ -86,5 +94,5 @@ private:
     int8_t _activeNote;
     size_t _size;
     size_t _write;
-    std::array<Event, 4> _events;
+    std::array<Event, CONFIG_RECORD_HISTORY_SIZE> _events;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <utility>
 #include <functional>
@@ -28,6 +29,10 @@ public:
         return _write == _read;
     }
 
+    // maximum number of queued values since last call to resetHighWater()
+    size_t highWater() const { return _highWater; }
+    void resetHighWater() { _highWater = 0; }
+
     void push(const T &value) {
         insert(value);
     }
@@ -72,6 +77,7 @@ private:
         }
 
         _write = increase(_write);
+        _highWater = std::max(_highWater, size());
 
         return cur;
     }
@@ -87,4 +93,5 @@ private:
     std::array<T, Capacity> _queue;
     size_t _read;
     size_t _write;
+    size_t _highWater = 0;
 };
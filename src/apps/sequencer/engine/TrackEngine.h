@@ -9,6 +9,8 @@
 
 #include "core/midi/MidiMessage.h"
 
+#include <algorithm>
+
 #include <cstdint>
 
 class Engine;
@@ -79,6 +81,13 @@ public:
 
     virtual float sequenceProgress() const { return -1.f; }
 
+    // diagnostics
+
+    virtual int gateQueueHighWater() const { return 0; }
+    virtual int cvQueueHighWater() const { return 0; }
+    virtual void resetQueueHighWater() {}
+    int queueHighWater() const { return std::max(gateQueueHighWater(), cvQueueHighWater()); }
+
     // helpers
 
     bool isSelected() const { return _model.project().selectedTrackIndex() == _track.trackIndex(); }
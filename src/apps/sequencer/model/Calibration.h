@@ -35,7 +35,6 @@ public:
         }
 
         const ItemArray &items() const { return _items; }
-              ItemArray &items()       { return _items; }
 
         int item(int index) const {
             return _items[index] & 0x7fff;
@@ -84,12 +83,15 @@ public:
         }
 
         uint16_t voltsToValue(float volts) const {
+            // convert to fixed point item position (segment index in upper bits, fraction in lower bits),
+            // clamping first keeps the position positive, so conversion truncates to the segment below
             volts = clamp(volts, float(MinVoltage), float(MaxVoltage));
-            float fIndex = (volts - MinVoltage) * ItemsPerVolt;
-            int index = std::floor(fIndex);
+            uint32_t position = uint32_t((volts - MinVoltage) * (ItemsPerVolt * float(1 << FractionBits)));
+            int index = position >> FractionBits;
             if (index < ItemCount - 1) {
-                float t = fIndex - index;
-                return lerp(t, item(index), item(index + 1));
+                const auto &segment = _segments[index];
+                int32_t fraction = position & ((1 << FractionBits) - 1);
+                return (segment.base + segment.slope * fraction) >> FractionBits;
             } else {
                 return item(ItemCount - 1);
             }
@@ -101,9 +103,19 @@ public:
         void read(ReadContext &context);
 
     private:
+        static constexpr int FractionBits = 16;
+
+        // linear segment between two items in fixed point
+        struct Segment {
+            int32_t base;
+            int32_t slope;
+        };
+
         void update();
+        void updateSegments();
 
         ItemArray _items;
+        std::array<Segment, ItemCount - 1> _segments;
     };
 
     typedef std::array<CvOutput, CONFIG_CV_OUTPUT_CHANNELS> CvOutputArray;
@@ -1,4 +1,5 @@
 #include "FileManager.h"
+#include "ProjectVersion.h"
 
 #include "core/utils/StringBuilder.h"
 
@@ -18,6 +19,8 @@ FileManager::TaskExecuteCallback FileManager::_taskExecuteCallback;
 FileManager::TaskResultCallback FileManager::_taskResultCallback;
 volatile uint32_t FileManager::_taskPending;
 
+FileManager::StreamCallback FileManager::_streamCallback;
+
 struct FileTypeInfo {
     const char *dir;
     const char *ext;
@@ -39,6 +42,7 @@ void FileManager::init() {
     _taskExecuteCallback = nullptr;
     _taskResultCallback = nullptr;
     _taskPending = 0;
+    _streamCallback = nullptr;
 }
 
 bool FileManager::volumeAvailable() {
@@ -76,17 +80,39 @@ fs::Error FileManager::loadProject(Project &project, int slot) {
     });
 }
 
-fs::Error FileManager::loadLastProject(Project &project) {
-    int slot;
+fs::Error FileManager::loadLastProjectSlot(int &slot) {
+    fs::FileReader fileReader("LAST.DAT");
+    if (fileReader.error() != fs::OK) {
+        return fileReader.error();
+    }
 
-    auto result = loadLastProject(slot);
+    fileReader.read(&slot, sizeof(slot));
 
-    if (result == fs::OK && slot >= 0) {
-        result = loadProject(project, slot);
-        project.setSlot(-1);
-    }
+    return fileReader.finish();
+}
 
-    return result;
+fs::Error FileManager::verifyProject(int slot) {
+    return loadFile(FileType::Project, slot, [&] (const char *path) {
+        fs::File file(path, fs::File::Read);
+        if (file.error() != fs::OK) {
+            return file.error();
+        }
+
+        // nested objects (user scales) write their own hash, the file can only be fully checked by reading it
+        FileHeader header;
+        uint32_t version;
+        size_t lenRead;
+        if (file.read(&header, sizeof(header), &lenRead) != fs::OK || lenRead != sizeof(header) ||
+            file.read(&version, sizeof(version), &lenRead) != fs::OK || lenRead != sizeof(version)) {
+            return file.error() != fs::OK ? file.error() : fs::END_OF_FILE;
+        }
+
+        if (header.type != FileType::Project || version > ProjectVersion::Latest) {
+            return fs::INVALID_CHECKSUM;
+        }
+
+        return fs::OK;
+    });
 }
 
 fs::Error FileManager::saveUserScale(const UserScale &userScale, int slot) {
@@ -161,6 +187,14 @@ void FileManager::processTask() {
         _taskPending = 0;
         _taskResultCallback(result);
     }
+
+    if ((_volumeState & Mounted) && _streamCallback) {
+        _streamCallback();
+    }
+}
+
+void FileManager::setStreamCallback(StreamCallback streamCallback) {
+    _streamCallback = streamCallback;
 }
 
 
@@ -206,17 +240,6 @@ fs::Error FileManager::saveLastProject(int slot) {
     return fileWriter.finish();
 }
 
-fs::Error FileManager::loadLastProject(int &slot) {
-    fs::FileReader fileReader("LAST.DAT");
-    if (fileReader.error() != fs::OK) {
-        return fileReader.error();
-    }
-
-    fileReader.read(&slot, sizeof(slot));
-
-    return fileReader.finish();
-}
-
 bool FileManager::cachedSlot(FileType type, int slot, SlotInfo &info) {
     for (auto &cachedSlotInfo : _cachedSlotInfos) {
         if (cachedSlotInfo.ticket != 0 && cachedSlotInfo.type == type && cachedSlotInfo.slot == slot) {
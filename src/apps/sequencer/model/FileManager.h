@@ -22,7 +22,10 @@ public:
 
     static fs::Error saveProject(Project &project, int slot);
     static fs::Error loadProject(Project &project, int slot);
-    static fs::Error loadLastProject(Project &project);
+    static fs::Error loadLastProjectSlot(int &slot);
+
+    // checks header and version of the project file in a slot without loading it
+    static fs::Error verifyProject(int slot);
 
     static fs::Error saveUserScale(const UserScale &userScale, int slot);
     static fs::Error loadUserScale(UserScale &userScale, int slot);
@@ -45,12 +48,17 @@ public:
     static void task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback);
     static void processTask();
 
+    // File streams (serviced by the file task after pending tasks)
+
+    typedef std::function<void(void)> StreamCallback;
+
+    static void setStreamCallback(StreamCallback streamCallback);
+
 private:
     static fs::Error saveFile(FileType type, int slot, std::function<fs::Error(const char *)> write);
     static fs::Error loadFile(FileType type, int slot, std::function<fs::Error(const char *)> read);
 
     static fs::Error saveLastProject(int slot);
-    static fs::Error loadLastProject(int &slot);
 
     static bool cachedSlot(FileType type, int slot, SlotInfo &info);
     static void cacheSlot(FileType type, int slot, const SlotInfo &info);
@@ -83,4 +91,6 @@ private:
     static TaskExecuteCallback _taskExecuteCallback;
     static TaskResultCallback _taskResultCallback;
     static volatile uint32_t _taskPending;
+
+    static StreamCallback _streamCallback;
 };
@@ -0,0 +1,166 @@
+#include "FlashJournal.h"
+
+#include "core/hash/Crc32.h"
+
+#include <algorithm>
+
+#include <cstring>
+
+FlashJournal::FlashJournal(uint32_t sector0, uint32_t sector1) {
+    uint32_t sectors[2] = { sector0, sector1 };
+
+    for (int i = 0; i < 2; ++i) {
+        auto &sector = _sectors[i];
+        sector.sector = sectors[i];
+        sector.address = Flash::sectorAddress(sectors[i]);
+        sector.size = Flash::sectorSize(sectors[i]);
+        scan(sector);
+    }
+
+    // sector with the most recent sequence number is active
+    for (int i = 0; i < 2; ++i) {
+        if (_sectors[i].valid && (_active == -1 || int32_t(_sectors[i].sequence - _sectors[_active].sequence) > 0)) {
+            _active = i;
+        }
+    }
+}
+
+bool FlashJournal::latest(uint32_t &address, size_t &length) const {
+    if (_active == -1 || _sectors[_active].recordLength == 0) {
+        return false;
+    }
+
+    address = _sectors[_active].recordAddress;
+    length = _sectors[_active].recordLength;
+    return true;
+}
+
+bool FlashJournal::append(const void *data, size_t length) {
+    uint32_t size = recordSize(length);
+    if (length == 0 || sizeof(SectorHeader) + size > std::min(_sectors[0].size, _sectors[1].size)) {
+        return false;
+    }
+
+    Flash::unlock();
+
+    if (_active != -1 && !_sectors[_active].full && _sectors[_active].position + size <= _sectors[_active].address + _sectors[_active].size) {
+        // append to active sector
+        auto &sector = _sectors[_active];
+        writeRecord(sector.position, data, length);
+        sector.recordAddress = sector.position + sizeof(RecordHeader);
+        sector.recordLength = length;
+        sector.position += size;
+    } else {
+        // start over in the other sector, the first sector is only used after
+        // the second one, so legacy data stored in the first sector is kept
+        int target = _active == 1 ? 0 : 1;
+        auto &sector = _sectors[target];
+
+        Flash::eraseSector(sector.sector);
+        ++_erases;
+
+        uint32_t recordAddress = sector.address + sizeof(SectorHeader);
+        writeRecord(recordAddress, data, length);
+
+        // commit sector
+        SectorHeader header;
+        header.magic = Magic;
+        header.sequence = _active != -1 ? _sectors[_active].sequence + 1 : 0;
+        header.crc = sectorHeaderCrc(header);
+        Flash::program(sector.address, header.magic);
+        Flash::program(sector.address + 4, header.sequence);
+        Flash::program(sector.address + 8, header.crc);
+
+        sector.valid = true;
+        sector.sequence = header.sequence;
+        sector.position = recordAddress + size;
+        sector.full = false;
+        sector.recordAddress = recordAddress + sizeof(RecordHeader);
+        sector.recordLength = length;
+
+        _active = target;
+    }
+
+    Flash::lock();
+
+    return true;
+}
+
+void FlashJournal::scan(Sector &sector) {
+    sector.position = sector.address + sizeof(SectorHeader);
+    sector.full = false;
+    sector.recordAddress = 0;
+    sector.recordLength = 0;
+
+    SectorHeader header;
+    Flash::read(sector.address, &header, sizeof(header));
+    sector.valid = header.magic == Magic && header.crc == sectorHeaderCrc(header);
+    sector.sequence = header.sequence;
+    if (!sector.valid) {
+        return;
+    }
+
+    uint32_t end = sector.address + sector.size;
+    while (sector.position + sizeof(RecordHeader) <= end) {
+        RecordHeader record;
+        Flash::read(sector.position, &record, sizeof(record));
+        if (record.length == Erased) {
+            break;
+        }
+        if (record.length == 0 || sector.position + recordSize(record.length) > end) {
+            // broken record header, remaining space cannot be used anymore
+            sector.full = true;
+            break;
+        }
+
+        // skip records with invalid data (partially written)
+        uint32_t address = sector.position + sizeof(RecordHeader);
+        if (dataCrc(address, record.length) == record.crc) {
+            sector.recordAddress = address;
+            sector.recordLength = record.length;
+        }
+
+        sector.position += recordSize(record.length);
+    }
+}
+
+void FlashJournal::writeRecord(uint32_t address, const void *data, size_t length) {
+    Crc32 crc;
+    crc(data, length);
+
+    // length is written first, a record with erased length is known to be empty
+    Flash::program(address, length);
+    Flash::program(address + 4, crc.result());
+    address += sizeof(RecordHeader);
+
+    const uint8_t *src = static_cast<const uint8_t *>(data);
+    while (length > 0) {
+        uint32_t word = Erased;
+        size_t chunk = std::min(length, sizeof(word));
+        std::memcpy(&word, src, chunk);
+        Flash::program(address, word);
+        address += sizeof(word);
+        src += chunk;
+        length -= chunk;
+    }
+}
+
+uint32_t FlashJournal::dataCrc(uint32_t address, size_t length) {
+    Crc32 crc;
+    uint8_t buffer[32];
+    while (length > 0) {
+        size_t chunk = std::min(length, sizeof(buffer));
+        Flash::read(address, buffer, chunk);
+        crc(buffer, chunk);
+        address += chunk;
+        length -= chunk;
+    }
+    return crc.result();
+}
+
+uint32_t FlashJournal::sectorHeaderCrc(const SectorHeader &header) {
+    Crc32 crc;
+    crc(&header.magic, sizeof(header.magic));
+    crc(&header.sequence, sizeof(header.sequence));
+    return crc.result();
+}
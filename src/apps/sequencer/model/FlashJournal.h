@@ -0,0 +1,80 @@
+#pragma once
+
+#include "drivers/Flash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Append-only journal of records stored in two flash sectors.
+//
+// Each save appends a new record to the active sector, only the latest valid
+// record is of interest when reading. Records are protected by a CRC, a record
+// that was not completely written (i.e. due to power loss) is skipped. When the
+// active sector is full, the record is written to the other sector instead,
+// which is erased first and only becomes active after the record was written
+// and the sector header was committed. This keeps the previous record intact
+// until the new one is safely stored.
+//
+// Sector layout:
+// - SectorHeader
+// - Record (RecordHeader + data padded to 4 bytes)
+// - Record ...
+// - erased space
+class FlashJournal {
+public:
+    FlashJournal(uint32_t sector0, uint32_t sector1);
+
+    // returns address and length of the latest valid record
+    bool latest(uint32_t &address, size_t &length) const;
+
+    // appends a record, returns false if the record does not fit into a sector
+    bool append(const void *data, size_t length);
+
+    // number of sector erases since construction
+    int erases() const { return _erases; }
+
+private:
+    static constexpr uint32_t Magic = 0x4a524e4c; // "JRNL"
+    static constexpr uint32_t Erased = 0xffffffff;
+
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t sequence;
+        uint32_t crc;
+    };
+
+    struct RecordHeader {
+        uint32_t length;
+        uint32_t crc;
+    };
+
+    struct Sector {
+        uint32_t sector;
+        uint32_t address;
+        uint32_t size;
+        bool valid;
+        uint32_t sequence;
+        // write position (end of last record)
+        uint32_t position;
+        // true if sector contains a corrupted record header, no more records can be appended
+        bool full;
+        // latest valid record
+        uint32_t recordAddress;
+        size_t recordLength;
+    };
+
+    void scan(Sector &sector);
+    void writeRecord(uint32_t address, const void *data, size_t length);
+
+    static uint32_t dataCrc(uint32_t address, size_t length);
+
+    static uint32_t recordSize(size_t length) {
+        return sizeof(RecordHeader) + ((length + 3) & ~3);
+    }
+
+    static uint32_t sectorHeaderCrc(const SectorHeader &header);
+
+    Sector _sectors[2];
+    int _active = -1;
+    int _erases = 0;
+};
@@ -5,17 +5,15 @@
 class FlashReader {
 public:
     FlashReader(uint32_t address) :
-        _address(reinterpret_cast<const uint8_t *>(address))
+        _address(address)
     {
     }
 
     void read(void *data, size_t len) {
-#ifdef PLATFORM_STM32
-        memcpy(data, _address, len);
-#endif
+        Flash::read(_address, data, len);
         _address += len;
     }
 
 private:
-    const uint8_t *_address;
+    uint32_t _address;
 };
@@ -0,0 +1,24 @@
+#include "MidiFileTrack.h"
+
+void MidiFileTrack::clear() {
+    setFile(1);
+    setFileTrack(0);
+    setChannel(-1);
+    setLoop(true);
+}
+
+void MidiFileTrack::write(WriteContext &context) const {
+    auto &writer = context.writer;
+    writer.write(_file);
+    writer.write(_fileTrack);
+    writer.write(_channel);
+    writer.write(_loop);
+}
+
+void MidiFileTrack::read(ReadContext &context) {
+    auto &reader = context.reader;
+    reader.read(_file);
+    reader.read(_fileTrack);
+    reader.read(_channel);
+    reader.read(_loop);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Config.h"
+#include "Types.h"
+#include "ModelUtils.h"
+#include "Serialize.h"
+
+#include "core/math/Math.h"
+#include "core/utils/StringBuilder.h"
+
+class MidiFileTrack {
+public:
+    //----------------------------------------
+    // Types
+    //----------------------------------------
+
+    static constexpr int MaxFile = 999;
+    static constexpr int MaxFileTrack = 64;
+
+    //----------------------------------------
+    // Properties
+    //----------------------------------------
+
+    // file
+
+    int file() const { return _file; }
+    void setFile(int file) {
+        _file = clamp(file, 1, MaxFile);
+    }
+
+    void editFile(int value, bool shift) {
+        setFile(file() + value * (shift ? 10 : 1));
+    }
+
+    void printFile(StringBuilder &str) const {
+        str("%03d.MID", file());
+    }
+
+    void filePath(StringBuilder &str) const {
+        str("MIDI/%03d.MID", file());
+    }
+
+    // fileTrack
+
+    int fileTrack() const { return _fileTrack; }
+    void setFileTrack(int fileTrack) {
+        _fileTrack = clamp(fileTrack, 0, MaxFileTrack - 1);
+    }
+
+    void editFileTrack(int value, bool shift) {
+        setFileTrack(fileTrack() + value);
+    }
+
+    void printFileTrack(StringBuilder &str) const {
+        str("%d", fileTrack() + 1);
+    }
+
+    // channel
+
+    int channel() const { return _channel; }
+    void setChannel(int channel) {
+        _channel = clamp(channel, -1, 15);
+    }
+
+    void editChannel(int value, bool shift) {
+        setChannel(channel() + value);
+    }
+
+    void printChannel(StringBuilder &str) const {
+        if (channel() == -1) {
+            str("Omni");
+        } else {
+            str("%d", channel() + 1);
+        }
+    }
+
+    // loop
+
+    bool loop() const { return _loop; }
+    void setLoop(bool loop) {
+        _loop = loop;
+    }
+
+    void editLoop(int value, bool shift) {
+        setLoop(value > 0);
+    }
+
+    void printLoop(StringBuilder &str) const {
+        ModelUtils::printYesNo(str, loop());
+    }
+
+    //----------------------------------------
+    // Methods
+    //----------------------------------------
+
+    MidiFileTrack() { clear(); }
+
+    void clear();
+
+    void write(WriteContext &context) const;
+    void read(ReadContext &context);
+
+private:
+    void setTrackIndex(int trackIndex) {
+        _trackIndex = trackIndex;
+    }
+
+    int8_t _trackIndex = -1;
+    uint16_t _file;
+    uint8_t _fileTrack;
+    int8_t _channel;
+    bool _loop;
+
+    friend class Track;
+};
@@ -6,5 +6,6 @@ Model::Model() :
 
 void Model::init() {
     _project.clear();
+    _setList.clear();
     _clipBoard.clear();
 }
@@ -2,6 +2,7 @@
 
 #include "Project.h"
 #include "Settings.h"
+#include "SetList.h"
 #include "ClipBoard.h"
 #include "Serialize.h"
 
@@ -36,6 +37,9 @@ public:
     const Settings &settings() const { return _settings; }
           Settings &settings()       { return _settings; }
 
+    const SetList &setList() const { return _setList; }
+          SetList &setList()       { return _setList; }
+
     const ClipBoard &clipBoard() const { return _clipBoard; }
           ClipBoard &clipBoard()       { return _clipBoard; }
 
@@ -50,5 +54,6 @@ public:
 private:
     Project _project;
     Settings _settings;
+    SetList _setList;
     ClipBoard _clipBoard;
 };
@@ -10,6 +10,47 @@
 #include <cstdint>
 #include <cmath>
 
+// Lookup table to quantize a position within an octave to the index of the
+// note at or below that position. Positions are integers in [0, range), note
+// positions need to be in ascending order. The octave is divided into a fixed
+// number of bins, each storing the index of the note at the start of the bin.
+// As long as notes are not closer than the bin width, a lookup resolves with
+// at most one compare against the following note.
+class QuantizeTable {
+public:
+    static constexpr int Bins = 32;
+
+    template<typename T>
+    void build(const T *notes, int count, int range) {
+        _shift = 0;
+        while (((range - 1) >> _shift) >= Bins) {
+            ++_shift;
+        }
+        int index = -1;
+        for (int bin = 0; bin < Bins; ++bin) {
+            int position = bin << _shift;
+            while (index + 1 < count && notes[index + 1] <= position) {
+                ++index;
+            }
+            _table[bin] = index;
+        }
+    }
+
+    // returns the index of the note at or below position or -1 if position is below the first note
+    template<typename T>
+    int lookup(const T *notes, int count, int position) const {
+        int index = _table[position >> _shift];
+        while (index + 1 < count && notes[index + 1] <= position) {
+            ++index;
+        }
+        return index;
+    }
+
+private:
+    int8_t _table[Bins];
+    uint8_t _shift = 0;
+};
+
 class Scale {
 public:
     enum Format {
@@ -49,6 +90,7 @@ public:
         _noteCount(noteCount),
         _notes(notes)
     {
+        _quantizeTable.build(_notes, _noteCount, OctaveRange);
     }
 
     bool isChromatic() const override {
@@ -79,21 +121,13 @@ public:
     float noteToVolts(int note) const override {
         int octave = roundDownDivide(note, _noteCount);
         int index = note - octave * _noteCount;
-        return octave + _notes[index] * (1.f / 1536.f);
+        return octave + _notes[index] * (1.f / OctaveRange);
     }
 
     int noteFromVolts(float volts) const override {
-        volts += 0.01f;
-        int octave = std::floor(volts);
-        float fractional = volts - octave;
-
-        int index = -1;
-        for (int i = 0; i < _noteCount; ++i) {
-            if (fractional < _notes[i] * (1.f / 1536.f)) {
-                break;
-            }
-            index = i;
-        }
+        int position = floorToInt((volts + 0.01f) * OctaveRange);
+        int octave = roundDownDivide(position, OctaveRange);
+        int index = _quantizeTable.lookup(_notes, _noteCount, position - octave * OctaveRange);
 
         if (index == -1) {
             index = _noteCount -1;
@@ -108,9 +142,13 @@ public:
     }
 
 private:
+    // notes are stored in 1/1536 volts (128 steps per semitone)
+    static constexpr int OctaveRange = 1536;
+
     bool _chromatic;
     uint16_t _noteCount;
     const uint16_t *_notes;
+    QuantizeTable _quantizeTable;
 };
 
 class VoltScale : public Scale {
@@ -144,7 +182,7 @@ public:
     }
 
     int noteFromVolts(float volts) const override {
-        return int(std::floor(volts / _interval));
+        return floorToInt(volts / _interval);
     }
 
     int notesPerOctave() const override {
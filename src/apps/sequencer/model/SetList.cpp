@@ -0,0 +1,135 @@
+#include "SetList.h"
+
+#include <algorithm>
+
+// project slots as used by the file select page
+static constexpr int SlotCount = 128;
+
+const char *SetList::Filename = "SETLIST.DAT";
+
+SetList::SetList() {
+    clear();
+}
+
+void SetList::setSlot(int entryIndex, int slot) {
+    if (isActiveEntry(entryIndex)) {
+        _entries[entryIndex] = clamp(slot, 0, SlotCount - 1);
+    }
+}
+
+void SetList::editSlot(int entryIndex, int value) {
+    if (isActiveEntry(entryIndex)) {
+        setSlot(entryIndex, slot(entryIndex) + value);
+    }
+}
+
+void SetList::insertEntry(int entryIndex, int slot) {
+    if (!isFull() && entryIndex >= 0 && entryIndex <= _entryCount) {
+        for (int i = _entryCount; i > entryIndex; --i) {
+            _entries[i] = _entries[i - 1];
+        }
+        ++_entryCount;
+        setSlot(entryIndex, slot);
+        if (_currentEntry >= entryIndex) {
+            ++_currentEntry;
+        }
+    }
+}
+
+void SetList::removeEntry(int entryIndex) {
+    if (isActiveEntry(entryIndex)) {
+        for (int i = entryIndex; i < _entryCount - 1; ++i) {
+            _entries[i] = _entries[i + 1];
+        }
+        --_entryCount;
+        if (_currentEntry == entryIndex) {
+            _currentEntry = -1;
+        } else if (_currentEntry > entryIndex) {
+            --_currentEntry;
+        }
+    }
+}
+
+void SetList::clear() {
+    _entries.fill(0);
+    _entryCount = 0;
+    _currentEntry = -1;
+}
+
+void SetList::write(WriteContext &context) const {
+    auto &writer = context.writer;
+
+    writer.write(_entryCount);
+    for (int i = 0; i < _entryCount; ++i) {
+        writer.write(_entries[i]);
+    }
+
+    writer.writeHash();
+}
+
+bool SetList::read(ReadContext &context) {
+    auto &reader = context.reader;
+
+    clear();
+
+    uint8_t entryCount;
+    reader.read(entryCount);
+    entryCount = std::min(entryCount, uint8_t(_entries.size()));
+    for (int i = 0; i < entryCount; ++i) {
+        reader.read(_entries[i]);
+    }
+
+    bool success = reader.checkHash();
+    if (success) {
+        _entryCount = entryCount;
+    } else {
+        clear();
+    }
+
+    return success;
+}
+
+fs::Error SetList::write(const char *path) const {
+    fs::FileWriter fileWriter(path);
+    if (fileWriter.error() != fs::OK) {
+        return fileWriter.error();
+    }
+
+    FileHeader header(FileType::SetList, 0, "SETLIST");
+    fileWriter.write(&header, sizeof(header));
+
+    VersionedSerializedWriter writer(
+        [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
+        Version
+    );
+
+    WriteContext context = { writer };
+    write(context);
+
+    return fileWriter.finish();
+}
+
+fs::Error SetList::read(const char *path) {
+    fs::FileReader fileReader(path);
+    if (fileReader.error() != fs::OK) {
+        return fileReader.error();
+    }
+
+    FileHeader header;
+    fileReader.read(&header, sizeof(header));
+
+    VersionedSerializedReader reader(
+        [&fileReader] (void *data, size_t len) { fileReader.read(data, len); },
+        Version
+    );
+
+    ReadContext context = { reader };
+    bool success = read(context);
+
+    auto error = fileReader.finish();
+    if (error == fs::OK && !success) {
+        error = fs::INVALID_CHECKSUM;
+    }
+
+    return error;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Config.h"
+#include "Serialize.h"
+#include "FileDefs.h"
+
+#include "core/math/Math.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Ordered list of project slots to be played one after another during a live set.
+// The set list is independent of the loaded project and stored in its own file.
+class SetList {
+public:
+    static constexpr uint32_t Version = 1;
+
+    static const char *Filename;
+
+    //----------------------------------------
+    // Properties
+    //----------------------------------------
+
+    // entries
+
+    int entryCount() const { return _entryCount; }
+    bool isFull() const { return _entryCount >= int(_entries.size()); }
+    bool isActiveEntry(int entryIndex) const { return entryIndex >= 0 && entryIndex < _entryCount; }
+
+    // project slot of an entry
+    int slot(int entryIndex) const { return _entries[entryIndex]; }
+    void setSlot(int entryIndex, int slot);
+    void editSlot(int entryIndex, int value);
+
+    // entry of the currently loaded project, -1 if not started
+    int currentEntry() const { return _currentEntry; }
+    void setCurrentEntry(int entryIndex) { _currentEntry = isActiveEntry(entryIndex) ? entryIndex : -1; }
+
+    // entry following the current one, -1 at the end of the set list
+    int nextEntry() const { return isActiveEntry(_currentEntry + 1) ? _currentEntry + 1 : -1; }
+
+    //----------------------------------------
+    // Methods
+    //----------------------------------------
+
+    SetList();
+
+    void insertEntry(int entryIndex, int slot);
+    void removeEntry(int entryIndex);
+
+    void clear();
+
+    void write(WriteContext &context) const;
+    bool read(ReadContext &context);
+
+    fs::Error write(const char *path) const;
+    fs::Error read(const char *path);
+
+private:
+    std::array<uint8_t, CONFIG_SET_LIST_ENTRY_COUNT> _entries;
+    uint8_t _entryCount;
+    int8_t _currentEntry;
+};
@@ -1,4 +1,11 @@
 #include "Settings.h"
+#include "FlashJournal.h"
+
+#include "core/Debug.h"
+
+#include <array>
+
+#include <cstring>
 
 const char *Settings::Filename = "SETTINGS.DAT";
 
@@ -74,18 +81,6 @@ fs::Error Settings::read(const char *path) {
     return error;
 }
 
-void Settings::write(FlashWriter &flashWriter) const {
-    VersionedSerializedWriter writer(
-        [&flashWriter] (const void *data, size_t len) { flashWriter.write(data, len); },
-        Version
-    );
-
-    WriteContext context = { writer };
-    write(context);
-
-    flashWriter.finish();
-}
-
 bool Settings::read(FlashReader &flashReader) {
     VersionedSerializedReader reader(
         [&flashReader] (void *data, size_t len) { flashReader.read(data, len); },
@@ -96,12 +91,37 @@ bool Settings::read(FlashReader &flashReader) {
     return read(context);
 }
 
-void Settings::writeToFlash() const {
-    FlashWriter flashWriter(CONFIG_SETTINGS_FLASH_ADDR, CONFIG_SETTINGS_FLASH_SECTOR);
-    write(flashWriter);
+bool Settings::writeToFlash() const {
+    // serialize to memory first, the journal writes a record in one go
+    std::array<uint8_t, FlashDataSize> data;
+    size_t length = 0;
+
+    VersionedSerializedWriter writer(
+        [&data, &length] (const void *src, size_t len) {
+            ASSERT(length + len <= data.size(), "settings exceed flash data size");
+            std::memcpy(&data[length], src, len);
+            length += len;
+        },
+        Version
+    );
+
+    WriteContext context = { writer };
+    write(context);
+
+    FlashJournal journal(CONFIG_SETTINGS_FLASH_SECTOR0, CONFIG_SETTINGS_FLASH_SECTOR1);
+    return journal.append(data.data(), length);
 }
 
 bool Settings::readFromFlash() {
-    FlashReader flashReader(CONFIG_SETTINGS_FLASH_ADDR);
+    FlashJournal journal(CONFIG_SETTINGS_FLASH_SECTOR0, CONFIG_SETTINGS_FLASH_SECTOR1);
+
+    uint32_t address;
+    size_t length;
+    if (!journal.latest(address, length)) {
+        // settings written by older firmware are stored at the start of the first sector
+        address = Flash::sectorAddress(CONFIG_SETTINGS_FLASH_SECTOR0);
+    }
+
+    FlashReader flashReader(address);
     return read(flashReader);
 }
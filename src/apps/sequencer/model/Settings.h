@@ -3,13 +3,15 @@
 #include "Calibration.h"
 #include "Serialize.h"
 #include "FileDefs.h"
-#include "FlashWriter.h"
 #include "FlashReader.h"
 
 class Settings {
 public:
     static constexpr uint32_t Version = 1;
 
+    // maximum size of serialized settings stored in flash
+    static constexpr size_t FlashDataSize = 512;
+
     static const char *Filename;
 
     Settings();
@@ -25,10 +27,10 @@ public:
     fs::Error write(const char *path) const;
     fs::Error read(const char *path);
 
-    void write(FlashWriter &flashWriter) const;
     bool read(FlashReader &flashReader);
 
-    void writeToFlash() const;
+    // returns false if the settings could not be written
+    bool writeToFlash() const;
     bool readFromFlash();
 
 private:
@@ -17,6 +17,7 @@ void Track::clearPattern(int patternIndex) {
         _track.curve->sequence(patternIndex).clear();
         break;
     case TrackMode::MidiCv:
+    case TrackMode::MidiFile:
         break;
     case TrackMode::Last:
         break;
@@ -32,6 +33,7 @@ void Track::copyPattern(int src, int dst) {
         _track.curve->sequence(dst) = _track.curve->sequence(src);
         break;
     case TrackMode::MidiCv:
+    case TrackMode::MidiFile:
         break;
     case TrackMode::Last:
         break;
@@ -42,6 +44,7 @@ void Track::gateOutputName(int index, StringBuilder &str) const {
     switch (_trackMode) {
     case TrackMode::Note:
     case TrackMode::Curve:
+    case TrackMode::MidiFile:
         str("Gate");
         break;
     case TrackMode::MidiCv:
@@ -56,6 +59,7 @@ void Track::cvOutputName(int index, StringBuilder &str) const {
     switch (_trackMode) {
     case TrackMode::Note:
     case TrackMode::Curve:
+    case TrackMode::MidiFile:
         str("CV");
         break;
     case TrackMode::MidiCv:
@@ -81,6 +85,9 @@ void Track::write(WriteContext &context) const {
     case TrackMode::MidiCv:
         _track.midiCv->write(context);
         break;
+    case TrackMode::MidiFile:
+        _track.midiFile->write(context);
+        break;
     case TrackMode::Last:
         break;
     }
@@ -103,6 +110,9 @@ void Track::read(ReadContext &context) {
     case TrackMode::MidiCv:
         _track.midiCv->read(context);
         break;
+    case TrackMode::MidiFile:
+        _track.midiFile->read(context);
+        break;
     case TrackMode::Last:
         break;
     }
@@ -112,6 +122,7 @@ void Track::initContainer() {
     _track.note = nullptr;
     _track.curve = nullptr;
     _track.midiCv = nullptr;
+    _track.midiFile = nullptr;
 
     switch (_trackMode) {
     case TrackMode::Note:
@@ -123,6 +134,9 @@ void Track::initContainer() {
     case TrackMode::MidiCv:
         _track.midiCv = _container.create<MidiCvTrack>();
         break;
+    case TrackMode::MidiFile:
+        _track.midiFile = _container.create<MidiFileTrack>();
+        break;
     case TrackMode::Last:
         break;
     }
@@ -146,6 +160,9 @@ void Track::setContainerTrackIndex(int trackIndex) {
     case TrackMode::MidiCv:
         _track.midiCv->setTrackIndex(trackIndex);
         break;
+    case TrackMode::MidiFile:
+        _track.midiFile->setTrackIndex(trackIndex);
+        break;
     case TrackMode::Last:
         break;
     }
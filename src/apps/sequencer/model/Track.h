@@ -7,6 +7,7 @@
 #include "NoteTrack.h"
 #include "CurveTrack.h"
 #include "MidiCvTrack.h"
+#include "MidiFileTrack.h"
 
 #include "core/Debug.h"
 #include "core/math/Math.h"
@@ -34,26 +35,29 @@ public:
         Note,
         Curve,
         MidiCv,
+        MidiFile,
         Last,
         Default = Note
     };
 
     static const char *trackModeName(TrackMode trackMode) {
         switch (trackMode) {
-        case TrackMode::Note:   return "Note";
-        case TrackMode::Curve:  return "Curve";
-        case TrackMode::MidiCv: return "MIDI/CV";
-        case TrackMode::Last:   break;
+        case TrackMode::Note:       return "Note";
+        case TrackMode::Curve:      return "Curve";
+        case TrackMode::MidiCv:     return "MIDI/CV";
+        case TrackMode::MidiFile:   return "MIDI File";
+        case TrackMode::Last:       break;
         }
         return nullptr;
     }
 
     static uint8_t trackModeSerialize(TrackMode trackMode) {
         switch (trackMode) {
-        case TrackMode::Note:   return 0;
-        case TrackMode::Curve:  return 1;
-        case TrackMode::MidiCv: return 2;
-        case TrackMode::Last:   break;
+        case TrackMode::Note:       return 0;
+        case TrackMode::Curve:      return 1;
+        case TrackMode::MidiCv:     return 2;
+        case TrackMode::MidiFile:   return 3;
+        case TrackMode::Last:       break;
         }
         return 0;
     }
@@ -109,6 +113,11 @@ public:
     const MidiCvTrack &midiCvTrack() const { SANITIZE_TRACK_MODE(_trackMode, TrackMode::MidiCv); return *_track.midiCv; }
           MidiCvTrack &midiCvTrack()       { SANITIZE_TRACK_MODE(_trackMode, TrackMode::MidiCv); return *_track.midiCv; }
 
+    // midiFileTrack
+
+    const MidiFileTrack &midiFileTrack() const { SANITIZE_TRACK_MODE(_trackMode, TrackMode::MidiFile); return *_track.midiFile; }
+          MidiFileTrack &midiFileTrack()       { SANITIZE_TRACK_MODE(_trackMode, TrackMode::MidiFile); return *_track.midiFile; }
+
     //----------------------------------------
     // Methods
     //----------------------------------------
@@ -154,11 +163,12 @@ private:
     TrackMode _trackMode;
     int8_t _linkTrack;
 
-    Container<NoteTrack, CurveTrack, MidiCvTrack> _container;
+    Container<NoteTrack, CurveTrack, MidiCvTrack, MidiFileTrack> _container;
     union {
         NoteTrack *note;
         CurveTrack *curve;
         MidiCvTrack *midiCv;
+        MidiFileTrack *midiFile;
     } _track;
 
     friend class Project;
@@ -34,6 +34,7 @@ public:
         Off,
         Cv1Cv2,
         Cv3Cv4,
+        Poly,
         Last
     };
 
@@ -42,6 +43,7 @@ public:
         case CvGateInput::Off:      return "Off";
         case CvGateInput::Cv1Cv2:   return "CV1/CV2";
         case CvGateInput::Cv3Cv4:   return "CV3/CV4";
+        case CvGateInput::Poly:     return "CV1-4 Poly";
         case CvGateInput::Last:     break;
         }
         return nullptr;
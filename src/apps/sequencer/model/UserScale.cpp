@@ -21,6 +21,7 @@ void UserScale::clearItems() {
     if (_mode == Mode::Voltage) {
         _items[1] = 1000;
     }
+    updateQuantizeTable();
 }
 
 void UserScale::write(WriteContext &context) const {
@@ -51,7 +52,9 @@ bool UserScale::read(ReadContext &context) {
     }
 
     bool success = reader.checkHash();
-    if (!success) {
+    if (success) {
+        updateQuantizeTable();
+    } else {
         clear();
     }
 
@@ -107,3 +110,16 @@ fs::Error UserScale::read(const char *path) {
 
     return error;
 }
+
+void UserScale::updateQuantizeTable() {
+    // items are not necessarily sorted, a note is only reached if no preceding
+    // item is above it, so quantize against the running maximum of the items
+    int16_t position = _items[0];
+    for (int i = 0; i < _size; ++i) {
+        position = std::max(position, _items[i]);
+        _positions[i] = position;
+    }
+
+    _octaveRange = _mode == Mode::Chromatic ? 12 : _items[_size - 1] - _items[0];
+    _quantizeTable.build(_positions.data(), _size, std::max(1, int(_octaveRange)));
+}
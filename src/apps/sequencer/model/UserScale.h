@@ -76,6 +76,7 @@ public:
     int size() const { return _size; }
     void setSize(int size) {
         _size = clamp(size, _mode == Mode::Chromatic ? 1 : 2, CONFIG_USER_SCALE_SIZE);
+        updateQuantizeTable();
     }
 
     void editSize(int value, bool shift) {
@@ -89,7 +90,6 @@ public:
     // items
 
     const ItemArray &items() const { return _items; }
-          ItemArray &items()       { return _items; }
 
     int item(int index) const { return _items[index]; }
     void setItem(int index, int value) {
@@ -103,6 +103,7 @@ public:
         case Mode::Last:
             break;
         }
+        updateQuantizeTable();
     }
 
     void editItem(int index, int value, int shift) {
@@ -233,17 +234,9 @@ private:
     }
 
     int noteFromVoltsChromaticMode(float volts) const {
-        int semiNotes = std::floor(volts * 12.f + 0.01f);
+        int semiNotes = floorToInt(volts * 12.f + 0.01f);
         int octave = roundDownDivide(semiNotes, 12);
-        semiNotes -= octave * 12;
-
-        int index = -1;
-        for (int i = 0; i < _size; ++i) {
-            if (semiNotes < _items[i]) {
-                break;
-            }
-            index = i;
-        }
+        int index = _quantizeTable.lookup(_positions.data(), _size, semiNotes - octave * 12);
 
         if (index == -1) {
             index = _size -1;
@@ -254,19 +247,15 @@ private:
     }
 
     int noteFromVoltsVoltageMode(float volts) const {
-        float octaveRange = octaveRangeVolts();
-        int octave = int(std::floor(volts / octaveRange));
-        volts -= octave * octaveRange;
-        int itemValue = int(std::floor(volts * 1000.f));
-
-        int index = -1;
-        for (int i = 0; i < _size; ++i) {
-            if (itemValue < _items[i]) {
-                break;
-            }
-            index = i;
+        // scale with an empty octave range cannot be quantized
+        if (_octaveRange <= 0) {
+            return 0;
         }
 
+        int itemValue = floorToInt(volts * 1000.f);
+        int octave = roundDownDivide(itemValue, _octaveRange);
+        int index = _quantizeTable.lookup(_positions.data(), _size, itemValue - octave * _octaveRange);
+
         if (index == -1) {
             index = _size -1;
             --octave;
@@ -279,8 +268,15 @@ private:
         return (_items[_size - 1] - _items[0]) * (1.f / 1000.f);
     }
 
+    void updateQuantizeTable();
+
     char _name[NameLength + 1];
     Mode _mode;
     uint8_t _size;
     ItemArray _items;
+
+    // quantization state, derived from the items
+    ItemArray _positions;
+    int16_t _octaveRange;
+    QuantizeTable _quantizeTable;
 };
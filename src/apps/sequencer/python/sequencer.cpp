@@ -1,5 +1,10 @@
 #include "SequencerApp.h"
 #include "model/Model.h"
+#include "model/FileManager.h"
+#include "engine/MidiFileExporter.h"
+
+#include "core/fs/File.h"
+#include "core/fs/FileSystem.h"
 
 #include <pybind11/pybind11.h>
 
@@ -13,6 +18,34 @@ void register_sequencer(py::module &m) {
     py::class_<SequencerApp> sequencer(m, "Sequencer");
     sequencer
         .def_property_readonly("model", [] (SequencerApp &app) { return &app.model; })
+        .def_property_readonly("engine", [] (SequencerApp &app) { return &app.engine; })
+    ;
+
+    // ------------------------------------------------------------------------
+    // Engine
+    // ------------------------------------------------------------------------
+
+    py::class_<Engine> engine(m, "Engine");
+    engine
+        .def_property_readonly("tick", &Engine::tick)
+        .def_property_readonly("running", [] (Engine &engine) { return engine.state().running(); })
+        .def_property("recording", &Engine::recording, &Engine::setRecording)
+        .def_property_readonly("projectSwitchPending", &Engine::projectSwitchPending)
+        .def_property_readonly("projectSwitchTime", &Engine::projectSwitchTime)
+        .def_property_readonly("gateOutput", &Engine::gateOutput)
+        .def("cvOutput", [] (Engine &engine, int channel) { return engine.cvOutput().channel(channel); })
+        .def("sendSysEx", [] (Engine &engine, int port, const py::bytes &data) {
+            std::string str = data;
+            return engine.sendSysEx(MidiPort(port), reinterpret_cast<const uint8_t *>(str.data()), str.size());
+        })
+        .def("beginSysEx", [] (Engine &engine, int port) { return engine.beginSysEx(MidiPort(port)); })
+        .def("appendSysEx", [] (Engine &engine, int port, const py::bytes &data) {
+            std::string str = data;
+            return engine.appendSysEx(MidiPort(port), reinterpret_cast<const uint8_t *>(str.data()), str.size());
+        })
+        .def("endSysEx", [] (Engine &engine, int port) { return engine.endSysEx(MidiPort(port)); })
+        .def_property_readonly("sysExRxBytes", [] (Engine &engine) { return engine.stats().sysExRxBytes; })
+        .def_property_readonly("sysExTxBytes", [] (Engine &engine) { return engine.stats().sysExTxBytes; })
     ;
 
     // ------------------------------------------------------------------------
@@ -22,6 +55,44 @@ void register_sequencer(py::module &m) {
     py::class_<Model> model(m, "Model");
     model
         .def_property_readonly("project", [] (Model &model) { return &model.project(); })
+        .def_property_readonly("setList", [] (Model &model) { return &model.setList(); })
+    ;
+
+    // ------------------------------------------------------------------------
+    // FileManager
+    // ------------------------------------------------------------------------
+
+    py::class_<FileManager> fileManager(m, "FileManager");
+    fileManager
+        .def_static("format", [] () { return FileManager::format() == fs::OK; })
+        .def_static("volumeMounted", &FileManager::volumeMounted)
+        .def_static("saveProject", [] (Project &project, int slot) { return FileManager::saveProject(project, slot) == fs::OK; })
+        .def_static("loadProject", [] (Project &project, int slot) { return FileManager::loadProject(project, slot) == fs::OK; })
+        .def_static("verifyProject", [] (int slot) { return FileManager::verifyProject(slot) == fs::OK; })
+        .def_static("mkdir", [] (const std::string &path) { return fs::mkdir(path.c_str()) == fs::OK; })
+        .def_static("readFile", [] (const std::string &path) {
+            fs::File file(path.c_str(), fs::File::Read);
+            std::string data(file.error() == fs::OK ? file.size() : 0, '\0');
+            if (!data.empty() && file.read(&data[0], data.size()) != fs::OK) {
+                data.clear();
+            }
+            return py::bytes(data);
+        })
+    ;
+
+    // ------------------------------------------------------------------------
+    // MidiFileExporter
+    // ------------------------------------------------------------------------
+
+    py::class_<MidiFileExporter> midiFileExporter(m, "MidiFileExporter");
+    midiFileExporter
+        .def_static("exportPattern", [] (const Project &project, int pattern, int bars, const std::string &path) {
+            return MidiFileExporter::exportPattern(project, pattern, bars, path.c_str()) == fs::OK;
+        })
+        .def_static("exportSong", [] (const Project &project, const std::string &path) {
+            return MidiFileExporter::exportSong(project, path.c_str()) == fs::OK;
+        })
+        .def_static("patternBars", &MidiFileExporter::patternBars)
     ;
 
     // ------------------------------------------------------------------------
@@ -83,6 +154,7 @@ void register_sequencer(py::module &m) {
         .value("Off", Types::CvGateInput::Off)
         .value("Cv1Cv2", Types::CvGateInput::Cv1Cv2)
         .value("Cv3Cv4", Types::CvGateInput::Cv3Cv4)
+        .value("Poly", Types::CvGateInput::Poly)
         .export_values()
     ;
 
@@ -208,6 +280,7 @@ void register_sequencer(py::module &m) {
         .def_property_readonly("noteTrack", [] (Track &track) { return &track.noteTrack(); })
         .def_property_readonly("curveTrack", [] (Track &track) { return &track.curveTrack(); })
         .def_property_readonly("midiCvTrack", [] (Track &track) { return &track.midiCvTrack(); })
+        .def_property_readonly("midiFileTrack", [] (Track &track) { return &track.midiFileTrack(); })
         .def("clear", &Track::clear)
         .def("clearPattern", &Track::clearPattern)
         .def("copyPattern", &Track::copyPattern)
@@ -217,6 +290,7 @@ void register_sequencer(py::module &m) {
         .value("Note", Track::TrackMode::Note)
         .value("Curve", Track::TrackMode::Curve)
         .value("MidiCv", Track::TrackMode::MidiCv)
+        .value("MidiFile", Track::TrackMode::MidiFile)
         .export_values()
     ;
 
@@ -325,6 +399,19 @@ void register_sequencer(py::module &m) {
         .export_values()
     ;
 
+    // ------------------------------------------------------------------------
+    // MidiFileTrack
+    // ------------------------------------------------------------------------
+
+    py::class_<MidiFileTrack> midiFileTrack(m, "MidiFileTrack");
+    midiFileTrack
+        .def_property("file", &MidiFileTrack::file, &MidiFileTrack::setFile)
+        .def_property("fileTrack", &MidiFileTrack::fileTrack, &MidiFileTrack::setFileTrack)
+        .def_property("channel", &MidiFileTrack::channel, &MidiFileTrack::setChannel)
+        .def_property("loop", &MidiFileTrack::loop, &MidiFileTrack::setLoop)
+        .def("clear", &MidiFileTrack::clear)
+    ;
+
     // ------------------------------------------------------------------------
     // Arpeggiator
     // ------------------------------------------------------------------------
@@ -492,6 +579,22 @@ void register_sequencer(py::module &m) {
         .def("clear", &Song::Slot::clear)
     ;
 
+    // ------------------------------------------------------------------------
+    // SetList
+    // ------------------------------------------------------------------------
+
+    py::class_<SetList> setList(m, "SetList");
+    setList
+        .def_property_readonly("entryCount", &SetList::entryCount)
+        .def("slot", &SetList::slot)
+        .def("setSlot", &SetList::setSlot)
+        .def_property("currentEntry", &SetList::currentEntry, &SetList::setCurrentEntry)
+        .def_property_readonly("nextEntry", &SetList::nextEntry)
+        .def("insertEntry", &SetList::insertEntry)
+        .def("removeEntry", &SetList::removeEntry)
+        .def("clear", &SetList::clear)
+    ;
+
     // ------------------------------------------------------------------------
     // PlayState
     // ------------------------------------------------------------------------
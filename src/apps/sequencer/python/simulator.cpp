@@ -1,4 +1,6 @@
+#include "sim/FrameCapture.h"
 #include "sim/Simulator.h"
+#include "sim/frontend/AudioRenderer.h"
 
 #include <pybind11/pybind11.h>
 
@@ -20,6 +22,10 @@ void register_simulator(py::module &m) {
         .def("setAdc", &Simulator::setAdc)
         .def("setDio", &Simulator::setDio)
         .def("sendMidi", &Simulator::sendMidi)
+        .def("sendSysEx", [] (Simulator &simulator, int port, const py::bytes &data) {
+            std::string str = data;
+            simulator.sendSysEx(port, std::vector<uint8_t>(str.begin(), str.end()));
+        })
         .def("screenshot", &Simulator::screenshot)
         .def_property_readonly("targetState", &Simulator::targetState, py::return_value_policy::reference)
     ;
@@ -36,4 +42,41 @@ void register_simulator(py::module &m) {
         .def("loadFromFile", &TargetTrace::loadFromFile)
         .def("saveToText", &TargetTrace::saveToText)
     ;
+
+    // ------------------------------------------------------------------------
+    // AudioRenderer
+    // ------------------------------------------------------------------------
+
+    py::class_<AudioRenderer> audioRenderer(m, "AudioRenderer", py::dynamic_attr());
+    audioRenderer
+        .def(py::init<Simulator &>(), py::keep_alive<1, 2>())
+
+        .def("start", &AudioRenderer::start)
+        .def("stop", &AudioRenderer::stop)
+        .def_property_readonly("recording", &AudioRenderer::recording)
+    ;
+
+    // ------------------------------------------------------------------------
+    // FrameCapture
+    // ------------------------------------------------------------------------
+
+    py::class_<FrameCapture> frameCapture(m, "FrameCapture", py::dynamic_attr());
+
+    // register format first, it is used as default argument
+    py::enum_<FrameCapture::Format>(frameCapture, "Format")
+        .value("Png", FrameCapture::Format::Png)
+        .value("Raw", FrameCapture::Format::Raw)
+    ;
+
+    frameCapture
+        .def(py::init<Simulator &, const std::string &, FrameCapture::Format, bool>(), py::keep_alive<1, 2>(),
+            py::arg("simulator"), py::arg("path"), py::arg("format") = FrameCapture::Format::Png, py::arg("leds") = false)
+
+        .def("close", &FrameCapture::close)
+        .def_property_readonly("width", &FrameCapture::width)
+        .def_property_readonly("height", &FrameCapture::height)
+        .def_property_readonly("frames", &FrameCapture::frames)
+        .def_property_readonly("capturedFrames", &FrameCapture::capturedFrames)
+        .def_property_readonly("failed", &FrameCapture::failed)
+    ;
 }
@@ -0,0 +1,258 @@
+#include "sim/Simulator.h"
+#include "SequencerApp.h"
+
+#include "model/FileDefs.h"
+#include "model/ProjectVersion.h"
+
+#include "core/io/VersionedSerializedReader.h"
+
+#include <pybind11/pybind11.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace py = pybind11;
+
+// Batch validation of project files. Each project is loaded into a fresh
+// simulator, played for a number of bars as fast as possible and summarized by
+// a few metrics. A checksum over all timed outputs allows to compare results
+// between firmware versions. The simulator is a singleton, so projects are
+// validated one after another in a process, parallelism is achieved with a
+// process pool (see tests/validate-projects.py).
+
+static constexpr int PlayButton = 24;
+
+// wait for startup to finish before loading the project
+static constexpr int StartupTime = 3000;
+
+struct ValidationResult {
+    std::string filename;
+    bool loaded = false;
+    bool completed = false;
+    std::string name;
+    uint32_t ticks = 0;
+    uint32_t engineTicks = 0;
+    double engineUpdateMean = 0.0;
+    double engineUpdateMax = 0.0;
+    double uiUpdateMean = 0.0;
+    int queueHighWater = 0;
+    uint32_t gateEvents = 0;
+    uint32_t cvEvents = 0;
+    uint32_t midiEvents = 0;
+    uint32_t checksum = 0;
+    double elapsed = 0.0;
+};
+
+// Hashes all output changes together with the tick they occurred (FNV-1a).
+class OutputChecksum : public sim::TargetOutputHandler, public sim::TargetTickHandler {
+public:
+    OutputChecksum(ValidationResult &result) :
+        _result(result)
+    {
+        _gates.fill(-1);
+        _dacs.fill(-1);
+    }
+
+    void setTick(uint32_t tick) override { _tick = tick; }
+
+    void writeGateOutput(int channel, bool value) override {
+        if (value != _gates[channel]) {
+            _gates[channel] = value;
+            add(0, channel, value);
+            ++_result.gateEvents;
+        }
+    }
+
+    void writeDac(int channel, uint16_t value) override {
+        if (value != _dacs[channel]) {
+            _dacs[channel] = value;
+            add(1, channel, value);
+            ++_result.cvEvents;
+        }
+    }
+
+    void writeMidiOutput(sim::MidiEvent event) override {
+        if (event.kind == sim::MidiEvent::Message) {
+            const auto &message = event.message;
+            for (int i = 0; i < message.length(); ++i) {
+                add(2, event.port, message.raw()[i]);
+            }
+            ++_result.midiEvents;
+        }
+    }
+
+    uint32_t checksum() const { return _hash; }
+
+private:
+    void add(uint32_t kind, uint32_t index, uint32_t value) {
+        for (uint32_t word : { _tick, kind, index, value }) {
+            for (int i = 0; i < 4; ++i) {
+                _hash = (_hash ^ ((word >> (i * 8)) & 0xff)) * 16777619u;
+            }
+        }
+    }
+
+    ValidationResult &_result;
+    std::array<int, CONFIG_CHANNEL_COUNT> _gates;
+    std::array<int, CONFIG_CHANNEL_COUNT> _dacs;
+    uint32_t _tick = 0;
+    uint32_t _hash = 2166136261u;
+};
+
+static bool loadProjectFile(Project &project, const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs) {
+        return false;
+    }
+
+    FileHeader header;
+    ifs.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!ifs || header.type != FileType::Project) {
+        return false;
+    }
+
+    VersionedSerializedReader reader(
+        [&ifs] (void *data, size_t len) { ifs.read(static_cast<char *>(data), len); },
+        ProjectVersion::Latest
+    );
+
+    ReadContext context = { reader };
+    return project.read(context) && ifs;
+}
+
+static ValidationResult validateProject(const std::string &filename, int bars) {
+    ValidationResult result;
+    result.filename = filename;
+
+    std::unique_ptr<SequencerApp> app;
+
+    using Clock = std::chrono::steady_clock;
+    double engineTotal = 0.0;
+    double uiTotal = 0.0;
+    uint32_t updates = 0;
+    bool measure = false;
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            if (!measure) {
+                app->update();
+                return;
+            }
+            auto start = Clock::now();
+            app->engine.update();
+            auto engineDone = Clock::now();
+            app->ui.update();
+            double engineTime = std::chrono::duration<double, std::micro>(engineDone - start).count();
+            engineTotal += engineTime;
+            uiTotal += std::chrono::duration<double, std::micro>(Clock::now() - engineDone).count();
+            result.engineUpdateMax = std::max(result.engineUpdateMax, engineTime);
+            ++updates;
+        }
+    });
+
+    simulator.wait(StartupTime);
+
+    auto &project = app->model.project();
+    app->engine.lock();
+    result.loaded = loadProjectFile(project, filename);
+    app->engine.unlock();
+    if (!result.loaded) {
+        return result;
+    }
+    result.name = project.name();
+
+    // only measure playback
+    measure = true;
+
+    OutputChecksum checksum(result);
+    simulator.registerTargetTickObserver(&checksum);
+    simulator.registerTargetOutputObserver(&checksum);
+
+    auto start = Clock::now();
+    simulator.setButton(PlayButton, true);
+    simulator.wait(10);
+    simulator.setButton(PlayButton, false);
+
+    // stop after the requested number of bars, the timeout guards against projects not advancing
+    uint32_t endTick = bars * app->engine.measureDivisor();
+    uint32_t timeout = std::max(1, bars) * 60000;
+    while (app->engine.tick() < endTick && result.ticks < timeout) {
+        simulator.wait(1);
+        ++result.ticks;
+    }
+
+    result.elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    simulator.unregisterTargetTickObserver(&checksum);
+    simulator.unregisterTargetOutputObserver(&checksum);
+
+    result.engineTicks = app->engine.tick();
+    result.completed = result.engineTicks >= endTick;
+    result.engineUpdateMean = updates > 0 ? engineTotal / updates : 0.0;
+    result.uiUpdateMean = updates > 0 ? uiTotal / updates : 0.0;
+    for (auto trackEngine : app->engine.trackEngines()) {
+        result.queueHighWater = std::max(result.queueHighWater, trackEngine->queueHighWater());
+    }
+    result.checksum = checksum.checksum();
+
+    return result;
+}
+
+void register_validation(py::module &m) {
+    // ------------------------------------------------------------------------
+    // ValidationResult
+    // ------------------------------------------------------------------------
+
+    py::class_<ValidationResult> validationResult(m, "ValidationResult");
+    validationResult
+        .def_readonly("filename", &ValidationResult::filename)
+        .def_readonly("loaded", &ValidationResult::loaded)
+        .def_readonly("completed", &ValidationResult::completed)
+        .def_readonly("name", &ValidationResult::name)
+        .def_readonly("ticks", &ValidationResult::ticks)
+        .def_readonly("engineTicks", &ValidationResult::engineTicks)
+        .def_readonly("engineUpdateMean", &ValidationResult::engineUpdateMean)
+        .def_readonly("engineUpdateMax", &ValidationResult::engineUpdateMax)
+        .def_readonly("uiUpdateMean", &ValidationResult::uiUpdateMean)
+        .def_readonly("queueHighWater", &ValidationResult::queueHighWater)
+        .def_readonly("gateEvents", &ValidationResult::gateEvents)
+        .def_readonly("cvEvents", &ValidationResult::cvEvents)
+        .def_readonly("midiEvents", &ValidationResult::midiEvents)
+        .def_readonly("checksum", &ValidationResult::checksum)
+        .def_readonly("elapsed", &ValidationResult::elapsed)
+        .def("toDict", [] (const ValidationResult &result) {
+            py::dict dict;
+            dict["filename"] = result.filename;
+            dict["loaded"] = result.loaded;
+            dict["completed"] = result.completed;
+            dict["name"] = result.name;
+            dict["ticks"] = result.ticks;
+            dict["engineTicks"] = result.engineTicks;
+            dict["engineUpdateMean"] = result.engineUpdateMean;
+            dict["engineUpdateMax"] = result.engineUpdateMax;
+            dict["uiUpdateMean"] = result.uiUpdateMean;
+            dict["queueHighWater"] = result.queueHighWater;
+            dict["gateEvents"] = result.gateEvents;
+            dict["cvEvents"] = result.cvEvents;
+            dict["midiEvents"] = result.midiEvents;
+            dict["checksum"] = result.checksum;
+            dict["elapsed"] = result.elapsed;
+            return dict;
+        })
+    ;
+
+    m.def("validateProject", &validateProject, py::arg("filename"), py::arg("bars") = 16,
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def("loadProjectFile", &loadProjectFile, py::arg("project"), py::arg("filename"));
+}
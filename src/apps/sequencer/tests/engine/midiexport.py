@@ -0,0 +1,129 @@
+import struct
+
+import testframework as tf
+
+BAR_TICKS = 16 * tf.STEP_TICKS
+
+def parse_midi_file(data):
+    (chunk, length, format, track_count, division) = struct.unpack(">4sIHHH", data[0:14])
+    assert chunk == b"MThd" and length == 6
+    pos = 14
+    tracks = []
+    for i in range(track_count):
+        (chunk, length) = struct.unpack(">4sI", data[pos:pos + 8])
+        assert chunk == b"MTrk"
+        tracks.append(parse_track(data[pos + 8:pos + 8 + length]))
+        pos += 8 + length
+    assert pos == len(data)
+    return (format, division, tracks)
+
+def read_variable_length(data, pos):
+    value = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value = (value << 7) | (byte & 0x7f)
+        if byte & 0x80 == 0:
+            return (value, pos)
+
+def parse_track(data):
+    # returns a list of (tick, bytes) tuples, meta events start with 0xff
+    events = []
+    tick = 0
+    pos = 0
+    while pos < len(data):
+        (delta, pos) = read_variable_length(data, pos)
+        tick += delta
+        status = data[pos]
+        if status == 0xff:
+            (length, start) = read_variable_length(data, pos + 2)
+            events.append((tick, data[pos:start + length]))
+            pos = start + length
+        else:
+            length = 2 if status & 0xf0 in (0xc0, 0xd0) else 3
+            events.append((tick, data[pos:pos + length]))
+            pos += length
+    assert events[-1][1] == b"\xff\x2f\x00", "end of track"
+    return events
+
+def notes(events):
+    # returns (tick, note, on) tuples
+    return [ (tick, e[1], e[0] & 0xf0 == 0x90) for (tick, e) in events if e[0] & 0xe0 == 0x80 ]
+
+class MidiExportTest(tf.UiTest):
+
+    def setUp(self):
+        super().setUp()
+        self.formatSdCard()
+
+        p = self.env.sequencer.model.project
+        p.clearPattern(0)
+        p.clearPattern(1)
+
+    def export_pattern(self, pattern, bars):
+        p = self.env.sequencer.model.project
+        self.assertTrue(tf.MidiFileExporter.exportPattern(p, pattern, bars, "PAT.MID"), "export")
+        return parse_midi_file(tf.FileManager.readFile("PAT.MID"))
+
+    def set_steps(self, pattern, track, steps):
+        s = self.env.sequencer.model.project.tracks[track].noteTrack.sequences[pattern].steps
+        for (index, note, length) in steps:
+            s[index].gate = True
+            s[index].note = note
+            s[index].length = length
+
+    def test_pattern(self):
+        self.set_steps(0, 0, [ (0, 0, 7), (4, 2, 3), (8, 4, 7), (12, 7, 3) ])
+        (format, division, tracks) = self.export_pattern(0, 2)
+
+        self.assertEqual(format, 1, "format")
+        self.assertEqual(division, 192, "division")
+        self.assertEqual(len(tracks), 9, "conductor track and one track per sequencer track")
+        self.assertEqual(tracks[0][-1][0], 2 * BAR_TICKS, "length")
+
+        expected = []
+        for bar in range(2):
+            for (step, note, length) in [ (0, 60, tf.STEP_TICKS), (4, 62, tf.STEP_TICKS // 2), (8, 64, tf.STEP_TICKS), (12, 67, tf.STEP_TICKS // 2) ]:
+                tick = bar * BAR_TICKS + step * tf.STEP_TICKS
+                expected += [ (tick, note, True), (tick + length, note, False) ]
+        self.assertEqual(notes(tracks[1]), expected, "notes")
+
+        for track in tracks[2:]:
+            self.assertEqual(notes(track), [], "empty track")
+
+    def test_swing(self):
+        self.env.sequencer.model.project.swing = 75
+        self.set_steps(0, 0, [ (0, 0, 3), (1, 1, 3) ])
+        (format, division, tracks) = self.export_pattern(0, 1)
+
+        # odd steps are delayed by the swing amount
+        on = [ tick for (tick, note, on) in notes(tracks[1]) if on ]
+        self.assertEqual(on, [ 0, tf.STEP_TICKS + tf.STEP_TICKS // 2 ], "swung notes")
+
+    def test_curve(self):
+        p = self.env.sequencer.model.project
+        p.setTrackMode(1, tf.Track.TrackMode.Curve)
+        s = p.tracks[1].curveTrack.sequences[0]
+        s.lastStep = 0
+        s.steps[0].shape = 4 # ramp up
+        s.steps[0].min = 0
+        s.steps[0].max = 255
+        (format, division, tracks) = self.export_pattern(0, 1)
+
+        # the step is sampled every 4 ticks and restarts every step
+        ramp = [ (tick, e[2]) for (tick, e) in tracks[2] if e[0] == 0xb1 and e[1] == 1 and tick < tf.STEP_TICKS ]
+        self.assertEqual(ramp, [ (tick, round(tick * 127 / tf.STEP_TICKS)) for tick in range(0, tf.STEP_TICKS, 4) ], "ramp")
+
+    def test_song(self):
+        p = self.env.sequencer.model.project
+        self.set_steps(0, 0, [ (0, 0, 7) ])
+        self.set_steps(1, 0, [ (0, 12, 7) ])
+        p.song.chainPattern(0)
+        p.song.chainPattern(1)
+        p.song.setRepeats(1, 2)
+        self.assertTrue(tf.MidiFileExporter.exportSong(p, "SONG.MID"), "export")
+        (format, division, tracks) = parse_midi_file(tf.FileManager.readFile("SONG.MID"))
+
+        self.assertEqual(tracks[0][-1][0], 3 * BAR_TICKS, "length")
+        on = [ (tick, note) for (tick, note, on) in notes(tracks[1]) if on ]
+        self.assertEqual(on, [ (0, 60), (BAR_TICKS, 72), (2 * BAR_TICKS, 72) ], "song notes")
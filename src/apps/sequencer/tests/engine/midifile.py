@@ -0,0 +1,37 @@
+import testframework as tf
+
+class MidiFileTest(tf.UiTest):
+
+    def setUp(self):
+        super().setUp()
+        self.formatSdCard()
+
+        p = self.env.sequencer.model.project
+        p.clearPattern(0)
+        p.clearPattern(1)
+
+    def test_playback(self):
+        p = self.env.sequencer.model.project
+        s = p.tracks[0].noteTrack.sequences[0].steps
+        for (index, note, length) in [ (0, 0, 7), (4, 2, 3), (8, 4, 7), (12, 7, 3) ]:
+            s[index].gate = True
+            s[index].note = note
+            s[index].length = length
+
+        # export the pattern and play back the first sequencer track (second track chunk) on track 2
+        self.assertTrue(tf.FileManager.mkdir("MIDI"), "mkdir")
+        self.assertTrue(tf.MidiFileExporter.exportPattern(p, 0, 1, "MIDI/001.MID"), "export")
+        p.setTrackMode(1, tf.Track.TrackMode.MidiFile)
+        t = p.tracks[1].midiFileTrack
+        t.file = 1
+        t.fileTrack = 1
+        self.controller.wait(100)
+
+        # track 2 follows track 1 over two loops of the file
+        engine = self.env.sequencer.engine
+        self.controller.press("play")
+        for step in range(32):
+            self.waitTick(step * tf.STEP_TICKS + tf.STEP_TICKS // 4)
+            gates = engine.gateOutput
+            self.assertEqual((gates >> 1) & 1, gates & 1, "gate of step %d" % step)
+            self.assertAlmostEqual(engine.cvOutput(1), engine.cvOutput(0), 3, "cv of step %d" % step)
@@ -0,0 +1,47 @@
+import testframework as tf
+
+class RecordTest(tf.UiTest):
+
+    def play_note(self, note, tick, length = 8):
+        c = self.controller
+        self.waitTick(tick)
+        c.midi(0, tf.core.MidiMessage.makeNoteOn(0, note))
+        self.waitTick(tick + length)
+        c.midi(0, tf.core.MidiMessage.makeNoteOff(0, note))
+
+    def record(self, swing, notes):
+        p = self.env.sequencer.model.project
+        p.swing = swing
+        self.env.sequencer.engine.recording = True
+        self.controller.press("play")
+        for (note, tick) in notes:
+            self.play_note(note, tick)
+        self.waitTick(17 * tf.STEP_TICKS)
+        self.env.sequencer.engine.recording = False
+        return p.tracks[0].noteTrack.sequences[0].steps
+
+    def test_record_dense(self):
+        # three notes per step, only the one closest to the step start is recorded
+        notes = []
+        for step in range(16):
+            start = step * tf.STEP_TICKS
+            notes += [ (60 + step, max(1, start - 6)), (90, start + 14), (91, start + 30) ]
+
+        steps = self.record(50, notes)
+        for step in range(1, 16):
+            self.assertTrue(steps[step].gate, "gate of step %d" % step)
+            self.assertEqual(steps[step].note, step, "note of step %d" % step)
+
+    def test_record_swing(self):
+        # notes played on the swung grid are quantized to the swung steps
+        notes = []
+        for step in range(16):
+            start = step * tf.STEP_TICKS
+            if step % 2 == 1:
+                start += 19
+            notes += [ (60 + step, max(1, start + 4)) ]
+
+        steps = self.record(70, notes)
+        for step in range(16):
+            self.assertTrue(steps[step].gate, "gate of step %d" % step)
+            self.assertEqual(steps[step].note, step, "note of step %d" % step)
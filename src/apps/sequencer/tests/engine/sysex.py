@@ -0,0 +1,54 @@
+import testframework as tf
+
+class SysExTest(tf.UiTest):
+
+    def message(self, length):
+        return bytes([0xf0] + [i & 0x7f for i in range(length - 2)] + [0xf7])
+
+    def test_receive(self):
+        engine = self.env.sequencer.engine
+        rxBytes = engine.sysExRxBytes
+        for port in [0, 1]:
+            self.controller.sysEx(port, self.message(100))
+            self.controller.wait(100)
+        self.assertEqual(engine.sysExRxBytes - rxBytes, 200, "received bytes")
+
+    def test_send_throughput(self):
+        # the din port transmits at 31250 baud (3125 bytes/s), messages are dropped if the buffer is full
+        engine = self.env.sequencer.engine
+        txBytes = engine.sysExTxBytes
+        message = self.message(64)
+        for ms in range(1000):
+            while engine.sendSysEx(0, message):
+                pass
+            self.controller.wait(1)
+        sent = engine.sysExTxBytes - txBytes
+        self.assertGreaterEqual(sent, 3125)
+        self.assertLessEqual(sent, 3125 + 256 + len(message))
+
+    def test_send_stream(self):
+        # messages larger than the transmit buffer are streamed, the din port needs ~320ms for 1000 bytes
+        engine = self.env.sequencer.engine
+        txBytes = engine.sysExTxBytes
+        data = bytes([i & 0x7f for i in range(1000)])
+        self.assertTrue(engine.beginSysEx(0), "begin")
+        self.assertFalse(engine.beginSysEx(0), "already in progress")
+        self.assertFalse(engine.sendSysEx(0, self.message(16)), "blocked by stream")
+        offset = 0
+        for ms in range(1000):
+            offset += engine.appendSysEx(0, data[offset:])
+            if offset == len(data):
+                break
+            self.controller.wait(1)
+        self.assertEqual(offset, len(data), "data queued")
+        while not engine.endSysEx(0):
+            self.controller.wait(1)
+        self.assertEqual(engine.sysExTxBytes - txBytes, len(data) + 2, "sent bytes")
+        self.assertEqual(engine.appendSysEx(0, data), 0, "no message in progress")
+
+    def test_send_invalid(self):
+        engine = self.env.sequencer.engine
+        self.assertFalse(engine.sendSysEx(0, bytes([0xf0, 0x01])), "unterminated")
+        self.assertFalse(engine.sendSysEx(1, bytes([0x01, 0xf7])), "no start")
+        self.assertFalse(engine.sendSysEx(0, bytes([0xf0] + [0] * 300 + [0xf7])), "too long")
+        self.assertTrue(engine.sendSysEx(1, self.message(16)), "valid")
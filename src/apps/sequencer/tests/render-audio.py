@@ -0,0 +1,33 @@
+import argparse
+import testframework as tf
+
+parser = argparse.ArgumentParser(description="Render the simulator instruments to a WAV file")
+parser.add_argument("output", help="output WAV file")
+parser.add_argument("--seconds", type=float, default=10.0, help="duration to render")
+parser.add_argument("--tempo", type=float, help="override project tempo")
+parser.add_argument("--project", help="project to render, either a slot index (starting at 0) on the simulated sd card or a project file")
+args = parser.parse_args()
+
+env = tf.Environment()
+c = tf.Controller(env.simulator)
+
+# wait for startup (loads last project)
+c.wait(3000)
+
+project = env.sequencer.model.project
+if args.project:
+    if args.project.isdigit():
+        loaded = tf.FileManager.loadProject(project, int(args.project))
+    else:
+        loaded = tf.loadProjectFile(project, args.project)
+    if not loaded:
+        parser.error("failed to load project '%s'" % args.project)
+if args.tempo:
+    project.tempo = args.tempo
+
+renderer = tf.simulator.AudioRenderer(env.simulator)
+renderer.start(args.output)
+c.press("play")
+c.wait(int(args.seconds * 1000))
+c.press("play")
+renderer.stop()
@@ -15,6 +15,9 @@ from .controller import Controller
 
 import unittest
 
+# ticks per step at default sequence divisor (1/16)
+STEP_TICKS = 48
+
 class UiTest(unittest.TestCase):
     def setUp(self):
         self.env = Environment()
@@ -24,3 +27,14 @@ class UiTest(unittest.TestCase):
     def tearDown(self):
         self.controller = None
         self.env = None
+
+    def waitTick(self, tick):
+        engine = self.env.sequencer.engine
+        while engine.tick < tick:
+            self.controller.wait(1)
+
+    def formatSdCard(self):
+        # start with an empty sd card, the volume is mounted by the file task
+        self.assertTrue(FileManager.format(), "format")
+        self.controller.wait(1100)
+        self.assertTrue(FileManager.volumeMounted(), "mounted")
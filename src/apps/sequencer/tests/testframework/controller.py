@@ -54,6 +54,7 @@ pageButtonMap = {
     "sequence" : "step2",
     "track" : "step3",
     "song" : "step4",
+    "setlist" : "step5",
     "monitor" : "step8",
     "overview" : "prev"
 }
@@ -133,6 +134,10 @@ class Controller:
         self._simulator.sendMidi(port, message)
         return self
 
+    def sysEx(self, port, data):
+        self._simulator.sendSysEx(port, data)
+        return self
+
     def screenshotDir(self, path):
         self._screenshotDir = path
         return self
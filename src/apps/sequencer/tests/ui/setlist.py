@@ -0,0 +1,72 @@
+import testframework as tf
+
+class SetListPageTest(tf.UiTest):
+
+    def setUp(self):
+        super().setUp()
+        p = self.env.sequencer.model.project
+        self.formatSdCard()
+
+        # two projects with different tempo
+        p.name = "FIRST"
+        p.tempo = 120
+        self.assertTrue(tf.FileManager.saveProject(p, 0), "save first project")
+        p.name = "SECOND"
+        p.tempo = 90
+        self.assertTrue(tf.FileManager.saveProject(p, 1), "save second project")
+        self.assertTrue(tf.FileManager.loadProject(p, 0), "load first project")
+
+        s = self.env.sequencer.model.setList
+        s.clear()
+        s.insertEntry(0, 0)
+        s.insertEntry(1, 1)
+        s.currentEntry = 0
+
+    def wait_switch(self):
+        engine = self.env.sequencer.engine
+        for i in range(5000):
+            if not engine.projectSwitchPending:
+                break
+            self.controller.wait(1)
+        self.assertFalse(engine.projectSwitchPending, "switch completed")
+
+    def test_next_stopped(self):
+        c = self.controller
+        c.selectPage("setlist")
+        c.press("f5")
+        self.wait_switch()
+
+        p = self.env.sequencer.model.project
+        self.assertEqual(p.name, "SECOND", "switched project")
+        self.assertEqual(self.env.sequencer.model.setList.currentEntry, 1, "current entry")
+
+        # end of set list
+        c.press("f5").wait()
+        self.assertEqual(p.name, "SECOND", "no next entry")
+
+    def test_next_playing(self):
+        c = self.controller
+        engine = self.env.sequencer.engine
+        c.selectPage("setlist")
+        c.press("play").wait(500)
+        self.assertTrue(engine.running, "playing")
+
+        tick = engine.tick
+        c.press("f5")
+        self.wait_switch()
+
+        # project is replaced on a bar boundary without stopping the clock
+        p = self.env.sequencer.model.project
+        self.assertEqual(p.name, "SECOND", "switched project")
+        self.assertTrue(engine.running, "still playing")
+        self.assertGreater(engine.tick, tick, "clock continued")
+        self.assertLess(engine.projectSwitchTime, 50, "switch time")
+
+    def test_invalid_slot(self):
+        c = self.controller
+        s = self.env.sequencer.model.setList
+        s.setSlot(1, 100)
+        c.selectPage("setlist")
+        c.press("f5").wait(100)
+        self.assertFalse(self.env.sequencer.engine.projectSwitchPending, "no switch")
+        self.assertEqual(self.env.sequencer.model.project.name, "FIRST", "project kept")
@@ -0,0 +1,77 @@
+import argparse
+import glob
+import json
+import multiprocessing
+import os
+import sys
+import tempfile
+
+import testframework as tf
+
+def init_worker():
+    # the simulated sd card is read from (and synced to) the working directory,
+    # give every worker its own one
+    os.chdir(tempfile.mkdtemp(prefix="performer-validate-"))
+
+def validate(job):
+    (filename, bars) = job
+    return tf.validateProject(filename, bars).toDict()
+
+def collect_projects(paths):
+    projects = []
+    for path in paths:
+        if os.path.isdir(path):
+            projects += sorted(glob.glob(os.path.join(path, "**", "*.PRO"), recursive=True))
+        else:
+            projects.append(path)
+    return [os.path.abspath(project) for project in projects]
+
+def main():
+    parser = argparse.ArgumentParser(description="Play a batch of projects in the simulator and report summary metrics")
+    parser.add_argument("projects", nargs="+", help="project files or directories containing project files")
+    parser.add_argument("--bars", type=int, default=16, help="number of bars to play per project")
+    parser.add_argument("--jobs", type=int, default=multiprocessing.cpu_count(), help="number of worker processes")
+    parser.add_argument("--output", help="write results to JSON file")
+    parser.add_argument("--reference", help="compare output checksums against results of a previous run")
+    args = parser.parse_args()
+
+    projects = collect_projects(args.projects)
+
+    reference = {}
+    if args.reference:
+        with open(args.reference) as f:
+            reference = { result["filename"]: result for result in json.load(f) }
+
+    results = []
+    failed = 0
+    with multiprocessing.Pool(args.jobs, initializer=init_worker) as pool:
+        for result in pool.imap_unordered(validate, [(project, args.bars) for project in projects]):
+            status = "ok"
+            if not result["loaded"]:
+                status = "LOAD FAILED"
+            elif not result["completed"]:
+                status = "NOT COMPLETED"
+            elif result["filename"] in reference and reference[result["filename"]]["checksum"] != result["checksum"]:
+                status = "CHECKSUM MISMATCH"
+            if status != "ok":
+                failed += 1
+            result["status"] = status
+            results.append(result)
+
+            print("%-32s %-8s engine %6.1f/%7.1f us  queue %2d  gate %6d  cv %6d  midi %6d  checksum %08x  %s" % (
+                os.path.basename(result["filename"]), result["name"],
+                result["engineUpdateMean"], result["engineUpdateMax"], result["queueHighWater"],
+                result["gateEvents"], result["cvEvents"], result["midiEvents"], result["checksum"], status
+            ))
+
+    print("%d projects validated, %d failed" % (len(results), failed))
+
+    if args.output:
+        results.sort(key=lambda result: result["filename"])
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+    return 1 if failed > 0 else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -3,7 +3,7 @@
 #include "Key.h"
 
 //  Project     Layout      Routing     MidiOutput  UserScale   -       -       System
-//  SequenceEdt Sequence    Track       Song        -           -       -       Monitor
+//  SequenceEdt Sequence    Track       Song        SetList     -       -       Monitor
 
 namespace PageKeyMap {
 
@@ -23,6 +23,7 @@ namespace PageKeyMap {
         Sequence        = Key::Step1,
         Track           = Key::Step2,
         Song            = Key::Step3,
+        SetList         = Key::Step4,
 
         System          = Key::Track7,
         Monitor         = Key::Step7,
@@ -45,6 +46,7 @@ namespace PageKeyMap {
         case Sequence:
         case Track:
         case Song:
+        case SetList:
 
         case System:
         case Monitor:
@@ -41,7 +41,7 @@ void Ui::init() {
 
     _engine.setMidiReceiveHandler([this] (MidiPort port, const MidiMessage &message) {
         if (!_midiMessages.writable()) {
-            DBG("ui midi buffer overflow");
+            DBG_WARNING("ui midi buffer overflow");
             _midiMessages.read();
         }
         _midiMessages.write({ port, message });
@@ -67,6 +67,13 @@ void Ui::init() {
 }
 
 void Ui::update() {
+    PROFILER_SCOPE(update, "ui.update")
+
+    // hold back ui updates while the project is replaced during a project switch
+    if (_engine.projectSuspended()) {
+        return;
+    }
+
     handleKeys();
     handleEncoder();
     handleMidi();
@@ -84,6 +91,7 @@ void Ui::update() {
     uint32_t currentTicks = os::ticks();
     uint32_t intervalTicks = os::time::ms(1000 / _pageManager.fps());
     if (currentTicks - _lastFrameBufferUpdateTicks >= intervalTicks) {
+        PROFILER_SCOPE(draw, "ui.draw")
         _pageManager.draw(_canvas);
         _messageManager.update();
         _messageManager.draw(_canvas);
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Config.h"
+
+#include "RoutableListModel.h"
+
+#include "model/MidiFileTrack.h"
+
+class MidiFileTrackListModel : public RoutableListModel {
+public:
+    void setTrack(MidiFileTrack &track) {
+        _track = &track;
+    }
+
+    virtual int rows() const override {
+        return Last;
+    }
+
+    virtual int columns() const override {
+        return 2;
+    }
+
+    virtual void cell(int row, int column, StringBuilder &str) const override {
+        if (column == 0) {
+            formatName(Item(row), str);
+        } else if (column == 1) {
+            formatValue(Item(row), str);
+        }
+    }
+
+    virtual void edit(int row, int column, int value, bool shift) override {
+        if (column == 1) {
+            editValue(Item(row), value, shift);
+        }
+    }
+
+    virtual Routing::Target routingTarget(int row) const override {
+        return Routing::Target::None;
+    }
+
+private:
+    enum Item {
+        File,
+        FileTrack,
+        Channel,
+        Loop,
+        Last
+    };
+
+    static const char *itemName(Item item) {
+        switch (item) {
+        case File:      return "File";
+        case FileTrack: return "Track";
+        case Channel:   return "Channel";
+        case Loop:      return "Loop";
+        case Last:      break;
+        }
+        return nullptr;
+    }
+
+    void formatName(Item item, StringBuilder &str) const {
+        str(itemName(item));
+    }
+
+    void formatValue(Item item, StringBuilder &str) const {
+        switch (item) {
+        case File:
+            _track->printFile(str);
+            break;
+        case FileTrack:
+            _track->printFileTrack(str);
+            break;
+        case Channel:
+            _track->printChannel(str);
+            break;
+        case Loop:
+            _track->printLoop(str);
+            break;
+        case Last:
+            break;
+        }
+    }
+
+    void editValue(Item item, int value, bool shift) {
+        switch (item) {
+        case File:
+            _track->editFile(value, shift);
+            break;
+        case FileTrack:
+            _track->editFileTrack(value, shift);
+            break;
+        case Channel:
+            _track->editChannel(value, shift);
+            break;
+        case Loop:
+            _track->editLoop(value, shift);
+            break;
+        case Last:
+            break;
+        }
+    }
+
+    MidiFileTrack *_track;
+};
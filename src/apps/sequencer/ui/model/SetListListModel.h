@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Config.h"
+
+#include "ListModel.h"
+
+#include "model/SetList.h"
+#include "model/FileManager.h"
+
+class SetListListModel : public ListModel {
+public:
+    SetListListModel(SetList &setList) :
+        _setList(setList)
+    {}
+
+    virtual int rows() const override {
+        return _setList.entryCount();
+    }
+
+    virtual int columns() const override {
+        return 2;
+    }
+
+    virtual void cell(int row, int column, StringBuilder &str) const override {
+        if (column == 0) {
+            str("%c %d", row == _setList.currentEntry() ? '>' : ' ', row + 1);
+        } else if (column == 1) {
+            FileManager::SlotInfo info;
+            FileManager::slotInfo(FileType::Project, _setList.slot(row), info);
+            str("%d: %s", _setList.slot(row) + 1, info.used ? info.name : "(empty)");
+        }
+    }
+
+    virtual void edit(int row, int column, int value, bool shift) override {
+        if (column == 1) {
+            _setList.editSlot(row, value * (shift ? 10 : 1));
+        }
+    }
+
+private:
+    SetList &_setList;
+};
@@ -5,6 +5,8 @@
 #include "engine/CvInput.h"
 #include "engine/CvOutput.h"
 
+#include "core/math/Math.h"
+#include "core/profiler/IrqProfiler.h"
 #include "core/utils/StringBuilder.h"
 
 enum class Function {
@@ -12,9 +14,14 @@ enum class Function {
     CvOut   = 1,
     Midi    = 2,
     Stats   = 3,
+    Irq     = 4,
 };
 
-static const char *functionNames[] = { "CV IN", "CV OUT", "MIDI", "STATS", nullptr };
+static const char *functionNames[] = { "CV IN", "CV OUT", "MIDI", "STATS", "IRQ" };
+
+static const char *midiFilterNames[] = { "ALL", "NOTES", "CTRL", "SYS" };
+
+static constexpr int MidiLogRows = 5;
 
 static void formatMidiMessage(StringBuilder &eventStr, StringBuilder &dataStr, const MidiMessage &msg) {
     if (msg.isChannelMessage()) {
@@ -87,7 +94,12 @@ void MonitorPage::exit() {
 void MonitorPage::draw(Canvas &canvas) {
     WindowPainter::clear(canvas);
     WindowPainter::drawHeader(canvas, _model, _engine, "MONITOR");
-    WindowPainter::drawActiveFunction(canvas, functionNames[int(_mode)]);
+    if (_mode == Mode::Midi) {
+        FixedStringBuilder<32> str("MIDI %s %s", _midiPortFilter == -1 ? "ALL" : midiPortName(MidiPort(_midiPortFilter)), midiFilterNames[int(_midiFilter)]);
+        WindowPainter::drawActiveFunction(canvas, str);
+    } else {
+        WindowPainter::drawActiveFunction(canvas, functionNames[int(_mode)]);
+    }
     WindowPainter::drawFooter(canvas, functionNames, pageKeyState(), int(_mode));
 
     canvas.setBlendMode(BlendMode::Set);
@@ -107,6 +119,9 @@ void MonitorPage::draw(Canvas &canvas) {
     case Mode::Stats:
         drawStats(canvas);
         break;
+    case Mode::Irq:
+        drawIrq(canvas);
+        break;
     }
 }
 
@@ -120,6 +135,24 @@ void MonitorPage::keyPress(KeyPressEvent &event) {
         return;
     }
 
+    if (key.isEncoder()) {
+        switch (_mode) {
+        case Mode::Midi:
+            // cycle message filter
+            _midiFilter = MidiFilter((int(_midiFilter) + 1) % int(MidiFilter::Last));
+            _midiScroll = 0;
+            break;
+        case Mode::Stats:
+        case Mode::Irq:
+            _engine.resetStats();
+            IrqProfiler::reset();
+            showMessage("STATISTICS RESET");
+            break;
+        default:
+            break;
+        }
+    }
+
     if (key.isFunction()) {
         switch (Function(key.function())) {
         case Function::CvIn:
@@ -134,17 +167,24 @@ void MonitorPage::keyPress(KeyPressEvent &event) {
         case Function::Stats:
             _mode = Mode::Stats;
             break;
+        case Function::Irq:
+            _mode = Mode::Irq;
+            break;
         }
     }
 }
 
 void MonitorPage::encoder(EncoderEvent &event) {
-}
+    if (_mode != Mode::Midi) {
+        return;
+    }
 
-void MonitorPage::midi(MidiEvent &event) {
-    _lastMidiMessage = event.message();
-    _lastMidiMessagePort = event.port();
-    _lastMidiMessageTicks = os::ticks();
+    if (globalKeyState()[Key::Shift]) {
+        _midiPortFilter = clamp(_midiPortFilter + event.value(), -1, int(MidiPort::CvGate));
+        _midiScroll = 0;
+    } else {
+        scrollMidiLog(event.value());
+    }
 }
 
 void MonitorPage::drawCvIn(Canvas &canvas) {
@@ -188,23 +228,57 @@ void MonitorPage::drawCvOut(Canvas &canvas) {
 }
 
 void MonitorPage::drawMidi(Canvas &canvas) {
+    const auto &midiLog = _engine.midiLog();
+
+    // the log is frozen while scrolled back
+    uint32_t head = _midiScroll > 0 ? _midiLogHead : midiLog.writeIndex();
 
-    if (os::ticks() - _lastMidiMessageTicks < os::time::ms(1000)) {
+    int entries = 0;
+    int row = 0;
+    MidiLog::Entry entry;
+    for (uint32_t index = head; midiLog.read(index - 1, entry); --index) {
+        if (!midiLogFilter(entry)) {
+            continue;
+        }
+        ++entries;
+        if (entries <= _midiScroll || row >= MidiLogRows) {
+            continue;
+        }
+
+        int y = 18 + row * 8;
+        FixedStringBuilder<16> tickStr("%u", unsigned(entry.tick));
         FixedStringBuilder<32> eventStr;
         FixedStringBuilder<32> dataStr;
-        formatMidiMessage(eventStr, dataStr, _lastMidiMessage);
-        canvas.drawTextCentered(0, 24 - 8, Width, 16, midiPortName(_lastMidiMessagePort));
-        canvas.drawTextCentered(0, 32 - 8, Width, 16, eventStr);
-        canvas.drawTextCentered(0, 40 - 8, Width, 16, dataStr);
+        formatMidiMessage(eventStr, dataStr, entry.message);
+        canvas.drawText(4, y, tickStr);
+        canvas.drawText(48, y, midiPortName(entry.port));
+        canvas.drawText(84, y, eventStr);
+        canvas.drawText(156, y, dataStr);
+        ++row;
+    }
+
+    if (entries == 0) {
+        canvas.drawTextCentered(0, 24, Width, 16, "NO MESSAGES");
     }
+
+    WindowPainter::drawScrollbar(canvas, Width - 4, 12, 2, MidiLogRows * 8, entries, MidiLogRows, _midiScroll);
 }
 
 void MonitorPage::drawStats(Canvas &canvas) {
     auto stats = _engine.stats();
 
+    // two columns of values, times are in us
     auto drawValue = [&] (int index, const char *name, const char *value) {
-        canvas.drawText(10, 20 + index * 10, name);
-        canvas.drawText(100, 20 + index * 10, value);
+        int x = index < 5 ? 4 : 132;
+        int y = 18 + (index % 5) * 8;
+        canvas.drawText(x, y, name);
+        canvas.drawText(x + 60, y, value);
+    };
+
+    auto drawTime = [&] (int index, const char *name, IrqProfiler::Source source) {
+        const auto &irqStats = IrqProfiler::stats(source);
+        FixedStringBuilder<24> str("%u <%u", unsigned(irqStats.durationMax), unsigned(irqStats.duration.percentile(99)));
+        drawValue(index, name, str);
     };
 
     {
@@ -216,7 +290,7 @@ void MonitorPage::drawStats(Canvas &canvas) {
     }
 
     {
-        FixedStringBuilder<16> str("%d", stats.midiRxOverflow);
+        FixedStringBuilder<16> str("%d/%d", stats.midiRxOverflow, stats.midiTxOverflow);
         drawValue(1, "MIDI OVF:", str);
     }
 
@@ -225,4 +299,112 @@ void MonitorPage::drawStats(Canvas &canvas) {
         drawValue(2, "USBMIDI OVF:", str);
     }
 
+    {
+        FixedStringBuilder<16> str("%u", unsigned(stats.sysExRxBytes));
+        drawValue(3, "SYSEX RX:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%u", unsigned(stats.sysExTxBytes));
+        drawValue(4, "SYSEX TX:", str);
+    }
+
+    {
+        FixedStringBuilder<24> str("%u/%u", unsigned(stats.updateTimeMean), unsigned(stats.updateTimeMax));
+        drawValue(5, "ENGINE:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%u", unsigned(stats.gateQueueHighWater));
+        drawValue(6, "GATE QUEUE:", str);
+    }
+
+    {
+        FixedStringBuilder<16> str("%u", unsigned(stats.cvQueueHighWater));
+        drawValue(7, "CV QUEUE:", str);
+    }
+
+    drawTime(8, "SDCARD:", IrqProfiler::Source::SdCard);
+    drawTime(9, "LCD:", IrqProfiler::Source::Lcd);
+}
+
+bool MonitorPage::midiLogFilter(const MidiLog::Entry &entry) const {
+    if (_midiPortFilter != -1 && entry.port != MidiPort(_midiPortFilter)) {
+        return false;
+    }
+
+    const auto &message = entry.message;
+    switch (_midiFilter) {
+    case MidiFilter::All:
+        return true;
+    case MidiFilter::Notes:
+        return message.isNoteOn() || message.isNoteOff();
+    case MidiFilter::Controllers:
+        return message.isChannelMessage() && !message.isNoteOn() && !message.isNoteOff();
+    case MidiFilter::System:
+        return message.isSystemMessage();
+    case MidiFilter::Last:
+        break;
+    }
+    return false;
+}
+
+int MonitorPage::midiLogEntries() const {
+    const auto &midiLog = _engine.midiLog();
+    uint32_t head = _midiScroll > 0 ? _midiLogHead : midiLog.writeIndex();
+
+    int entries = 0;
+    MidiLog::Entry entry;
+    for (uint32_t index = head; midiLog.read(index - 1, entry); --index) {
+        entries += midiLogFilter(entry) ? 1 : 0;
+    }
+    return entries;
+}
+
+void MonitorPage::scrollMidiLog(int value) {
+    // freeze the log when starting to scroll back
+    if (_midiScroll == 0) {
+        _midiLogHead = _engine.midiLog().writeIndex();
+    }
+    _midiScroll = clamp(_midiScroll + value, 0, std::max(0, midiLogEntries() - MidiLogRows));
+}
+
+void MonitorPage::drawIrq(Canvas &canvas) {
+    FixedStringBuilder<16> str;
+
+    // durations and latencies in us, percentiles are upper bounds of the histogram bins
+    int y = 16;
+    canvas.drawText(64, y, "COUNT");
+    canvas.drawText(104, y, "DUR MAX");
+    canvas.drawText(144, y, "P99");
+    canvas.drawText(184, y, "LAT MAX");
+    canvas.drawText(224, y, "P99");
+
+    for (int i = 0; i < int(IrqProfiler::Source::Last); ++i) {
+        auto source = IrqProfiler::Source(i);
+        const auto &stats = IrqProfiler::stats(source);
+        y += 7;
+
+        canvas.drawText(10, y, IrqProfiler::sourceName(source));
+
+        str.reset();
+        str("%u", unsigned(stats.count));
+        canvas.drawText(64, y, str);
+
+        str.reset();
+        str("%u", unsigned(stats.durationMax));
+        canvas.drawText(104, y, str);
+
+        str.reset();
+        str("<%u", unsigned(stats.duration.percentile(99)));
+        canvas.drawText(144, y, str);
+
+        str.reset();
+        str("%u", unsigned(stats.latencyMax));
+        canvas.drawText(184, y, str);
+
+        str.reset();
+        str("<%u", unsigned(stats.latency.percentile(99)));
+        canvas.drawText(224, y, str);
+    }
 }
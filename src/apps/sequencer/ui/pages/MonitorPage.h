@@ -2,10 +2,9 @@
 
 #include "BasePage.h"
 
+#include "engine/MidiLog.h"
 #include "engine/MidiPort.h"
 
-#include "core/midi/MidiMessage.h"
-
 class MonitorPage : public BasePage {
 public:
     MonitorPage(PageManager &manager, PageContext &context);
@@ -18,23 +17,39 @@ public:
 
     virtual void keyPress(KeyPressEvent &event) override;
     virtual void encoder(EncoderEvent &event) override;
-    virtual void midi(MidiEvent &event) override;
 
 private:
     void drawCvIn(Canvas &canvas);
     void drawCvOut(Canvas &canvas);
     void drawMidi(Canvas &canvas);
     void drawStats(Canvas &canvas);
+    void drawIrq(Canvas &canvas);
+
+    bool midiLogFilter(const MidiLog::Entry &entry) const;
+    int midiLogEntries() const;
+    void scrollMidiLog(int value);
 
     enum class Mode : uint8_t {
         CvIn,
         CvOut,
         Midi,
         Stats,
+        Irq,
+    };
+
+    enum class MidiFilter : uint8_t {
+        All,
+        Notes,
+        Controllers,
+        System,
+        Last
     };
 
     Mode _mode = Mode::CvIn;
-    MidiMessage _lastMidiMessage;
-    MidiPort _lastMidiMessagePort;
-    uint32_t _lastMidiMessageTicks = -1;
+
+    // midi log
+    MidiFilter _midiFilter = MidiFilter::All;
+    int8_t _midiPortFilter = -1;    // -1 for all ports
+    int _midiScroll = 0;            // number of filtered entries scrolled back
+    uint32_t _midiLogHead = 0;      // write index of the log when scrolling started
 };
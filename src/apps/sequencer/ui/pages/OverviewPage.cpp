@@ -137,6 +137,7 @@ void OverviewPage::draw(Canvas &canvas) {
             drawCurveTrack(canvas, trackIndex, trackEngine.as<CurveTrackEngine>(), track.curveTrack().sequence(trackState.pattern()));
             break;
         case Track::TrackMode::MidiCv:
+        case Track::TrackMode::MidiFile:
             break;
         case Track::TrackMode::Last:
             break;
@@ -22,6 +22,7 @@
 #include "ProjectPage.h"
 #include "QuickEditPage.h"
 #include "RoutingPage.h"
+#include "SetListPage.h"
 #include "SongPage.h"
 #include "StartupPage.h"
 #include "SystemPage.h"
@@ -51,6 +52,7 @@ struct Pages {
     PatternPage pattern;
     PerformerPage performer;
     SongPage song;
+    SetListPage setList;
     RoutingPage routing;
     MidiOutputPage midiOutput;
     UserScalePage userScale;
@@ -92,6 +94,7 @@ struct Pages {
         pattern(manager, context),
         performer(manager, context),
         song(manager, context),
+        setList(manager, context),
         routing(manager, context),
         midiOutput(manager, context),
         userScale(manager, context),
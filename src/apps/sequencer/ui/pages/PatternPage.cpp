@@ -5,6 +5,9 @@
 #include "ui/LedPainter.h"
 #include "ui/painters/WindowPainter.h"
 
+#include "engine/MidiFileExporter.h"
+
+#include "model/FileManager.h"
 #include "model/PlayState.h"
 
 #include "core/utils/StringBuilder.h"
@@ -22,6 +25,7 @@ enum class ContextAction {
     Copy,
     Paste,
     Duplicate,
+    Export,
     Last
 };
 
@@ -30,6 +34,7 @@ static const ContextMenuModel::Item contextMenuItems[] = {
     { "COPY" },
     { "PASTE" },
     { "DUP"},
+    { "EXPORT" },
 };
 
 
@@ -327,6 +332,9 @@ void PatternPage::contextAction(int index) {
     case ContextAction::Duplicate:
         duplicatePattern();
         break;
+    case ContextAction::Export:
+        exportPattern();
+        break;
     case ContextAction::Last:
         break;
     }
@@ -336,6 +344,8 @@ bool PatternPage::contextActionEnabled(int index) const {
     switch (ContextAction(index)) {
     case ContextAction::Paste:
         return _model.clipBoard().canPastePattern();
+    case ContextAction::Export:
+        return FileManager::volumeMounted();
     default:
         return true;
     }
@@ -365,3 +375,22 @@ void PatternPage::duplicatePattern() {
         showMessage("PATTERN DUPLICATED");
     }
 }
+
+void PatternPage::exportPattern() {
+    int pattern = _project.selectedPatternIndex();
+
+    // the exporter only reads the project, playback continues while exporting
+    _manager.pages().busy.show("EXPORTING PATTERN ...");
+
+    FileManager::task([this, pattern] () {
+        return MidiFileExporter::exportPattern(_project, pattern);
+    }, [this] (fs::Error result) {
+        if (result == fs::OK) {
+            showMessage("PATTERN EXPORTED");
+        } else {
+            showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
+        }
+        // TODO lock ui mutex
+        _manager.pages().busy.close();
+    });
+}
@@ -0,0 +1,149 @@
+#include "SetListPage.h"
+
+#include "ui/pages/Pages.h"
+#include "ui/painters/WindowPainter.h"
+
+#include "model/FileManager.h"
+
+#include "core/utils/StringBuilder.h"
+
+enum class Function {
+    Insert  = 0,
+    Remove  = 1,
+    Save    = 2,
+    Go      = 3,
+    Next    = 4,
+};
+
+static const char *functionNames[] = { "INSERT", "REMOVE", "SAVE", "GO", "NEXT" };
+
+SetListPage::SetListPage(PageManager &manager, PageContext &context) :
+    ListPage(manager, context, _listModel),
+    _listModel(context.model.setList())
+{}
+
+void SetListPage::enter() {
+    ListPage::enter();
+}
+
+void SetListPage::exit() {
+}
+
+void SetListPage::draw(Canvas &canvas) {
+    WindowPainter::clear(canvas);
+    WindowPainter::drawHeader(canvas, _model, _engine, "SET LIST");
+    if (_engine.projectSwitchPending()) {
+        WindowPainter::drawActiveFunction(canvas, "SWITCHING");
+    }
+    WindowPainter::drawFooter(canvas, functionNames, pageKeyState());
+
+    ListPage::draw(canvas);
+}
+
+void SetListPage::keyPress(KeyPressEvent &event) {
+    const auto &key = event.key();
+
+    if (key.isFunction()) {
+        switch (Function(key.function())) {
+        case Function::Insert:
+            insertEntry();
+            break;
+        case Function::Remove:
+            removeEntry();
+            break;
+        case Function::Save:
+            saveSetList();
+            break;
+        case Function::Go:
+            switchToEntry(selectedRow());
+            break;
+        case Function::Next:
+            switchToEntry(_model.setList().nextEntry());
+            break;
+        }
+        event.consume();
+        return;
+    }
+
+    ListPage::keyPress(event);
+}
+
+void SetListPage::insertEntry() {
+    auto &setList = _model.setList();
+    if (setList.isFull()) {
+        showMessage("SET LIST IS FULL");
+        return;
+    }
+    // add the loaded project after the selected entry
+    int entryIndex = setList.entryCount() > 0 ? selectedRow() + 1 : 0;
+    setList.insertEntry(entryIndex, _project.slotAssigned() ? _project.slot() : 0);
+    setSelectedRow(entryIndex);
+}
+
+void SetListPage::removeEntry() {
+    _model.setList().removeEntry(selectedRow());
+    setSelectedRow(selectedRow());
+}
+
+void SetListPage::saveSetList() {
+    if (!FileManager::volumeMounted()) {
+        return;
+    }
+
+    // the set list is not used by the engine, no need to lock it
+    _manager.pages().busy.show("SAVING SET LIST ...");
+
+    FileManager::task([this] () {
+        return _model.setList().write(SetList::Filename);
+    }, [this] (fs::Error result) {
+        if (result == fs::OK) {
+            showMessage("SET LIST SAVED");
+        } else {
+            showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
+        }
+        // TODO lock ui mutex
+        _manager.pages().busy.close();
+    });
+}
+
+void SetListPage::switchToEntry(int entryIndex) {
+    const auto &setList = _model.setList();
+    if (!setList.isActiveEntry(entryIndex) || !FileManager::volumeMounted() || _engine.projectSwitchPending()) {
+        return;
+    }
+
+    int slot = setList.slot(entryIndex);
+
+    // Check the project file while the current project keeps playing. The project is only replaced
+    // once the engine has suspended the track engines on the next bar boundary, the clock keeps running.
+    FileManager::task([slot] () {
+        return FileManager::verifyProject(slot);
+    }, [this, entryIndex, slot] (fs::Error result) {
+        if (result == fs::INVALID_CHECKSUM) {
+            showMessage("INVALID PROJECT FILE");
+            return;
+        } else if (result != fs::OK) {
+            showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
+            return;
+        }
+
+        // the project is loaded from the file task once the engine has suspended the track engines
+        _engine.requestProjectSwitch([this, slot] () {
+            auto result = FileManager::loadProject(_project, slot);
+            if (result != fs::OK) {
+                // reading may have failed half way, continue with an empty project instead
+                _project.clear();
+            }
+            return result;
+        }, [this, entryIndex] (fs::Error result) {
+            if (result == fs::OK) {
+                _model.setList().setCurrentEntry(entryIndex);
+                showMessage("PROJECT SWITCHED");
+            } else if (result == fs::TIMEOUT) {
+                showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
+            } else {
+                showMessage(FixedStringBuilder<32>("FAILED (%s), CLEARED", fs::errorToString(result)));
+            }
+        });
+    });
+}
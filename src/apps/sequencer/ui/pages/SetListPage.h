@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ListPage.h"
+
+#include "ui/model/SetListListModel.h"
+
+class SetListPage : public ListPage {
+public:
+    SetListPage(PageManager &manager, PageContext &context);
+
+    virtual void enter() override;
+    virtual void exit() override;
+
+    virtual void draw(Canvas &canvas) override;
+
+    virtual void keyPress(KeyPressEvent &event) override;
+
+private:
+    void insertEntry();
+    void removeEntry();
+    void saveSetList();
+    void switchToEntry(int entryIndex);
+
+    SetListListModel _listModel;
+};
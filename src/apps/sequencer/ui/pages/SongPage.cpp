@@ -6,17 +6,22 @@
 #include "ui/painters/WindowPainter.h"
 #include "ui/painters/SongPainter.h"
 
+#include "engine/MidiFileExporter.h"
+
+#include "model/FileManager.h"
 #include "model/PlayState.h"
 
 #include "core/utils/StringBuilder.h"
 
 enum class ContextAction {
     Init,
+    Export,
     Last
 };
 
 static const ContextMenuModel::Item contextMenuItems[] = {
     { "INIT" },
+    { "EXPORT" },
 };
 
 enum class Function {
@@ -378,6 +383,9 @@ void SongPage::contextAction(int index) {
     case ContextAction::Init:
         initSong();
         break;
+    case ContextAction::Export:
+        exportSong();
+        break;
     case ContextAction::Last:
         break;
     }
@@ -385,6 +393,8 @@ void SongPage::contextAction(int index) {
 
 bool SongPage::contextActionEnabled(int index) const {
     switch (ContextAction(index)) {
+    case ContextAction::Export:
+        return _project.song().slotCount() > 0 && FileManager::volumeMounted();
     default:
         return true;
     }
@@ -396,3 +406,20 @@ void SongPage::initSong() {
     setSelectedSlot(_selectedSlot);
     showMessage("SONG INITIALIZED");
 }
+
+void SongPage::exportSong() {
+    // the exporter only reads the project, playback continues while exporting
+    _manager.pages().busy.show("EXPORTING SONG ...");
+
+    FileManager::task([this] () {
+        return MidiFileExporter::exportSong(_project);
+    }, [this] (fs::Error result) {
+        if (result == fs::OK) {
+            showMessage("SONG EXPORTED");
+        } else {
+            showMessage(FixedStringBuilder<32>("FAILED (%s)", fs::errorToString(result)));
+        }
+        // TODO lock ui mutex
+        _manager.pages().busy.close();
+    });
+}
@@ -34,6 +34,7 @@ private:
     bool contextActionEnabled(int index) const;
 
     void initSong();
+    void exportSong();
 
     enum class Mode : uint8_t {
         Idle,
@@ -15,11 +15,24 @@ StartupPage::StartupPage(PageManager &manager, PageContext &context) :
 void StartupPage::draw(Canvas &canvas) {
     if (_state == State::Initial) {
         _state = State::Loading;
-        _engine.lock();
+        // mounting the volume and resolving the last project happens without
+        // holding the engine, it is only locked while the project is replaced
         FileManager::task([this] () {
-            return FileManager::loadLastProject(_model.project());
+            // the set list is optional
+            if (fs::exists(SetList::Filename)) {
+                _model.setList().read(SetList::Filename);
+            }
+
+            int slot;
+            auto result = FileManager::loadLastProjectSlot(slot);
+            if (result == fs::OK && slot >= 0) {
+                _engine.lock();
+                result = FileManager::loadProject(_model.project(), slot);
+                _model.project().setSlot(-1);
+                _engine.unlock();
+            }
+            return result;
         }, [this] (fs::Error result) {
-            _engine.unlock();
             _state = State::Ready;
         });
     }
@@ -21,7 +21,7 @@ private:
     float time() const;
     float relTime() const { return time() / LoadTime; }
 
-    static constexpr int LoadTime = 2;
+    static constexpr int LoadTime = 1;
 
     uint32_t _startTicks;
     State _state = State::Initial;
@@ -330,10 +330,13 @@ void SystemPage::saveSettingsToFlash() {
     _manager.pages().busy.show("SAVING SETTINGS ...");
 
     FileManager::task([this] () {
-        _model.settings().writeToFlash();
-        return fs::OK;
+        return _model.settings().writeToFlash() ? fs::OK : fs::DISK_FULL;
     }, [this] (fs::Error result) {
-        showMessage("SETTINGS SAVED");
+        if (result == fs::OK) {
+            showMessage("SETTINGS SAVED");
+        } else {
+            showMessage("FAILED TO SAVE SETTINGS");
+        }
         // TODO lock ui mutex
         _manager.pages().busy.close();
         _engine.unlock();
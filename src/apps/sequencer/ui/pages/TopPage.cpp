@@ -172,6 +172,9 @@ void TopPage::setMode(Mode mode) {
     case Mode::Song:
         setMainPage(pages.song);
         break;
+    case Mode::SetList:
+        setMainPage(pages.setList);
+        break;
     case Mode::Routing:
         setMainPage(pages.routing);
         break;
@@ -221,6 +224,7 @@ void TopPage::setSequencePage() {
         setMainPage(pages.curveSequence);
         break;
     case Track::TrackMode::MidiCv:
+    case Track::TrackMode::MidiFile:
         setMainPage(pages.track);
         break;
     case Track::TrackMode::Last:
@@ -239,6 +243,7 @@ void TopPage::setSequenceEditPage() {
         setMainPage(pages.curveSequenceEdit);
         break;
     case Track::TrackMode::MidiCv:
+    case Track::TrackMode::MidiFile:
         setMainPage(pages.track);
         break;
     case Track::TrackMode::Last:
@@ -83,6 +83,10 @@ void TrackPage::setTrack(Track &track) {
         _midiCvTrackListModel.setTrack(track.midiCvTrack());
         newListModel = &_midiCvTrackListModel;
         break;
+    case Track::TrackMode::MidiFile:
+        _midiFileTrackListModel.setTrack(track.midiFileTrack());
+        newListModel = &_midiFileTrackListModel;
+        break;
     case Track::TrackMode::Last:
         ASSERT(false, "invalid track mode");
         break;
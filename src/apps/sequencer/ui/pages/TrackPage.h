@@ -5,6 +5,7 @@
 #include "ui/model/NoteTrackListModel.h"
 #include "ui/model/CurveTrackListModel.h"
 #include "ui/model/MidiCvTrackListModel.h"
+#include "ui/model/MidiFileTrackListModel.h"
 
 class TrackPage : public ListPage {
 public:
@@ -34,4 +35,5 @@ private:
     NoteTrackListModel _noteTrackListModel;
     CurveTrackListModel _curveTrackListModel;
     MidiCvTrackListModel _midiCvTrackListModel;
+    MidiFileTrackListModel _midiFileTrackListModel;
 };
@@ -1,6 +1,7 @@
 #include "Debug.h"
 
 #include "drivers/Console.h"
+#include "drivers/HighResolutionTimer.h"
 #include "stb/stb_sprintf.h"
 
 #if CONFIG_ENABLE_DEBUG
@@ -36,6 +37,8 @@ void dbg_assert(bool cond, const char *filename, int line, const char *fmt, ...)
         va_start(va, fmt);
         stbsp_vsprintfcb(&dbg_write, buf, buf, fmt, va);
         va_end(va);
+        // the console does not block, make sure the message is sent before trapping
+        Console::flush();
         if (assert_handler) {
             char msg[128];
             stbsp_vsnprintf(msg, sizeof(msg), fmt, va);
@@ -46,4 +49,16 @@ void dbg_assert(bool cond, const char *filename, int line, const char *fmt, ...)
     }
 }
 
+#if CONFIG_ENABLE_DEBUG_TRACE
+void dbg_trace(uint8_t id, uint32_t value) {
+    uint32_t time = HighResolutionTimer::us();
+    uint8_t frame[10] = {
+        0xa5, id,
+        uint8_t(time), uint8_t(time >> 8), uint8_t(time >> 16), uint8_t(time >> 24),
+        uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)
+    };
+    Console::writeRaw(frame, sizeof(frame));
+}
+#endif // CONFIG_ENABLE_DEBUG_TRACE
+
 #endif // CONFIG_ENABLE_DEBUG
@@ -2,22 +2,63 @@
 
 #include "SystemConfig.h"
 
+#include <stdint.h>
+
+// Log levels
+#define DBG_LEVEL_NONE      0
+#define DBG_LEVEL_ERROR     1
+#define DBG_LEVEL_WARNING   2
+#define DBG_LEVEL_INFO      3
+#define DBG_LEVEL_DEBUG     4
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #if CONFIG_ENABLE_DEBUG
 void dbg_printf(char const *fmt, ...) __attribute__((__format__(__printf__, 1, 2)));
-# define DBG(_fmt_, ...) dbg_printf(_fmt_ "\n", ##__VA_ARGS__)
 typedef void AssertHandler(const char *filename, int line, const char *msg);
 void dbg_set_assert_handler(AssertHandler *handler);
 void dbg_assert(bool cond, const char *filename, int line, const char *fmt, ...) __attribute__((__format__(__printf__, 4, 5)));
 # define ASSERT(_cond_, _fmt_, ...) dbg_assert(_cond_, __FILE__, __LINE__, _fmt_ "\n", ##__VA_ARGS__)
 #else // CONFIG_ENABLE_DEBUG
-# define DBG(_fmt_, ...)
 # define ASSERT(_conf_, _fmt_, ...)
 #endif // CONFIG_ENABLE_DEBUG
 
+#if CONFIG_ENABLE_DEBUG && CONFIG_DEBUG_LEVEL >= DBG_LEVEL_ERROR
+# define DBG_ERROR(_fmt_, ...) dbg_printf("E: " _fmt_ "\n", ##__VA_ARGS__)
+#else
+# define DBG_ERROR(_fmt_, ...)
+#endif
+
+#if CONFIG_ENABLE_DEBUG && CONFIG_DEBUG_LEVEL >= DBG_LEVEL_WARNING
+# define DBG_WARNING(_fmt_, ...) dbg_printf("W: " _fmt_ "\n", ##__VA_ARGS__)
+#else
+# define DBG_WARNING(_fmt_, ...)
+#endif
+
+#if CONFIG_ENABLE_DEBUG && CONFIG_DEBUG_LEVEL >= DBG_LEVEL_INFO
+# define DBG_INFO(_fmt_, ...) dbg_printf(_fmt_ "\n", ##__VA_ARGS__)
+#else
+# define DBG_INFO(_fmt_, ...)
+#endif
+
+#if CONFIG_ENABLE_DEBUG && CONFIG_DEBUG_LEVEL >= DBG_LEVEL_DEBUG
+# define DBG(_fmt_, ...) dbg_printf(_fmt_ "\n", ##__VA_ARGS__)
+#else
+# define DBG(_fmt_, ...)
+#endif
+
+// Binary trace for high rate events. Each call emits a 10 byte frame
+// [0xa5, id, timestamp (us, 4 bytes LE), value (4 bytes LE)] to the console.
+// Text output is plain ASCII so the sync byte cannot be mistaken for text.
+#if CONFIG_ENABLE_DEBUG && CONFIG_ENABLE_DEBUG_TRACE
+void dbg_trace(uint8_t id, uint32_t value);
+# define DBG_TRACE(_id_, _value_) dbg_trace(_id_, _value_)
+#else
+# define DBG_TRACE(_id_, _value_)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
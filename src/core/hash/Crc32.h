@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3) using a 16 entry lookup table.
+class Crc32 {
+public:
+    uint32_t result() const { return ~_crc; }
+
+    void operator()(uint8_t data) {
+        _crc = table()[(_crc ^ data) & 0xf] ^ (_crc >> 4);
+        _crc = table()[(_crc ^ (data >> 4)) & 0xf] ^ (_crc >> 4);
+    }
+
+    void operator()(const void *data, size_t len) {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+        while (len-- > 0) {
+            (*this)(*src++);
+        }
+    }
+
+private:
+    static const uint32_t *table() {
+        static const uint32_t table[16] = {
+            0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+            0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+        };
+        return table;
+    }
+
+    uint32_t _crc = 0xffffffff;
+};
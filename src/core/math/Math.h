@@ -34,6 +34,12 @@ inline int roundDownDivide(int a, int b) {
     return a >= 0 ? (a / b) : (a - b + 1) / b;
 }
 
+// floor to integer without calling into libm (the M4 has no rounding instructions)
+inline int floorToInt(float x) {
+    int i = int(x);
+    return x < i ? i - 1 : i;
+}
+
 inline float deg2rad(float deg) {
     return deg / 180.f * M_PI;
 }
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Standard MIDI File (SMF) definitions and encoding helpers.
+// All multi byte values in SMF chunks are stored big endian.
+namespace MidiFile {
+
+enum class Format : uint16_t {
+    SingleTrack = 0,
+    MultiTrack  = 1,
+    MultiSong   = 2,
+};
+
+enum class MetaType : uint8_t {
+    TrackName       = 0x03,
+    EndOfTrack      = 0x2f,
+    Tempo           = 0x51,
+    TimeSignature   = 0x58,
+};
+
+static constexpr uint8_t MetaEvent = 0xff;
+static constexpr uint8_t SysExEvent = 0xf0;
+static constexpr uint8_t SysExEscapeEvent = 0xf7;
+
+static constexpr size_t ChunkHeaderSize = 8;
+static constexpr size_t HeaderChunkLength = 6;
+
+// maximum number of bytes used by a variable length quantity
+static constexpr size_t MaxVariableLength = 4;
+static constexpr uint32_t MaxVariableLengthValue = 0x0fffffff;
+
+static inline void encodeUint16(uint8_t *data, uint16_t value) {
+    data[0] = value >> 8;
+    data[1] = value;
+}
+
+static inline void encodeUint32(uint8_t *data, uint32_t value) {
+    data[0] = value >> 24;
+    data[1] = value >> 16;
+    data[2] = value >> 8;
+    data[3] = value;
+}
+
+// encodes a variable length quantity (7 bits per byte, most significant first)
+// returns the number of bytes written
+static inline size_t encodeVariableLength(uint8_t *data, uint32_t value) {
+    value &= MaxVariableLengthValue;
+    size_t len = 1;
+    for (uint32_t rest = value >> 7; rest; rest >>= 7) {
+        ++len;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t byte = (value >> (7 * (len - 1 - i))) & 0x7f;
+        data[i] = i < len - 1 ? (byte | 0x80) : byte;
+    }
+    return len;
+}
+
+static inline void encodeChunkHeader(uint8_t *data, const char *id, uint32_t length) {
+    for (int i = 0; i < 4; ++i) {
+        data[i] = id[i];
+    }
+    encodeUint32(&data[4], length);
+}
+
+static inline uint16_t decodeUint16(const uint8_t *data) {
+    return (data[0] << 8) | data[1];
+}
+
+static inline uint32_t decodeUint32(const uint8_t *data) {
+    return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+}
+
+// decodes a variable length quantity from at most len bytes
+// returns the number of bytes read or 0 if the quantity is incomplete
+static inline size_t decodeVariableLength(const uint8_t *data, size_t len, uint32_t &value) {
+    value = 0;
+    for (size_t i = 0; i < len && i < MaxVariableLength; ++i) {
+        value = (value << 7) | (data[i] & 0x7f);
+        if (!(data[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static inline bool isChunk(const uint8_t *data, const char *id) {
+    for (int i = 0; i < 4; ++i) {
+        if (data[i] != uint8_t(id[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// number of data bytes following a channel message status byte
+static inline size_t channelMessageLength(uint8_t status) {
+    switch (status & 0xf0) {
+    case 0xc0:
+    case 0xd0:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+} // namespace MidiFile
@@ -18,12 +18,12 @@ bool MidiParser::feed(uint8_t data) {
             switch (MidiMessage::systemMessage(data)) {
             case MidiMessage::SystemExclusive:
                 // start system exclusive receive
-                _recvSystemExclusive = true;
+                startSysEx();
                 break;
             case MidiMessage::TimeCode:
             case MidiMessage::SongPosition:
             case MidiMessage::SongSelect:
-                _recvSystemExclusive = false;
+                emitSysEx(true, true);
                 // update running status
                 _status = data;
                 // receive data
@@ -31,18 +31,24 @@ bool MidiParser::feed(uint8_t data) {
                 _dataLength = MidiMessage::systemMessageLength(MidiMessage::systemMessage(data));
                 break;
             case MidiMessage::TuneRequest:
-                _recvSystemExclusive = false;
+                emitSysEx(true, true);
                 // emit tune-request message
                 _message = MidiMessage(data);
                 return true;
             case MidiMessage::EndOfExclusive:
                 // end system exclusive receive
-                _recvSystemExclusive = false;
-                // TODO emit message
+                if (_recvSystemExclusive) {
+                    writeSysEx(data);
+                    emitSysEx(true, false);
+                }
+                break;
+            default:
+                // undefined system common messages also end system exclusive receive
+                emitSysEx(true, true);
                 break;
             }
         } else if (MidiMessage::isChannelMessage(data)) {
-            _recvSystemExclusive = false;
+            emitSysEx(true, true);
             // update running status
             _status = data;
             // receive data
@@ -54,7 +60,7 @@ bool MidiParser::feed(uint8_t data) {
     } else {
         // DBG("data %d data length %d", _dataIndex, _dataLength);
         if (_recvSystemExclusive) {
-            // TODO add to buffer
+            writeSysEx(data);
         } else if (_dataLength > 0) {
             _data[_dataIndex++] = data;
             if (_dataIndex == _dataLength) {
@@ -67,3 +73,34 @@ bool MidiParser::feed(uint8_t data) {
     }
     return false;
 }
+
+void MidiParser::startSysEx() {
+    // abort unterminated message
+    emitSysEx(true, true);
+
+    _recvSystemExclusive = true;
+    _sysExFirst = true;
+    writeSysEx(MidiMessage::SystemExclusive);
+}
+
+void MidiParser::writeSysEx(uint8_t data) {
+    if (_sysExLength == SysExChunkSize) {
+        emitSysEx(false, false);
+    }
+    _sysExData[_sysExLength++] = data;
+}
+
+void MidiParser::emitSysEx(bool last, bool aborted) {
+    if (!_recvSystemExclusive) {
+        return;
+    }
+
+    if (_sysExHandler) {
+        SysExChunk chunk = { _sysExData, _sysExLength, _sysExFirst, last, aborted };
+        _sysExHandler(chunk);
+    }
+
+    _sysExLength = 0;
+    _sysExFirst = false;
+    _recvSystemExclusive = !last;
+}
@@ -2,10 +2,31 @@
 
 #include "MidiMessage.h"
 
+#include <functional>
+
+#include <cstddef>
 #include <cstdint>
 
 class MidiParser {
 public:
+    // SysEx messages are not buffered as a whole but passed on in chunks while they are received.
+    // The first chunk starts with SystemExclusive (0xf0), the last chunk ends with EndOfExclusive (0xf7).
+    // A SysEx message interrupted by another (non real-time) status byte is ended by a chunk marked as aborted.
+    static constexpr size_t SysExChunkSize = 16;
+
+    // undefined system common status byte, used by drivers to abort a SysEx message they had to drop data of
+    static constexpr uint8_t SysExAbort = 0xf4;
+
+    struct SysExChunk {
+        const uint8_t *data;
+        size_t length;
+        bool first;
+        bool last;
+        bool aborted;
+    };
+
+    typedef std::function<void(const SysExChunk &chunk)> SysExHandler;
+
     MidiParser() {
     }
 
@@ -15,7 +36,15 @@ public:
         return _message;
     }
 
+    void setSysExHandler(SysExHandler handler) {
+        _sysExHandler = handler;
+    }
+
 private:
+    void startSysEx();
+    void writeSysEx(uint8_t data);
+    void emitSysEx(bool last, bool aborted);
+
     uint8_t _status = 0;
     uint8_t _data[2] = { 0, 0 };
     uint8_t _dataIndex = 0;
@@ -23,4 +52,9 @@ private:
     bool _recvSystemExclusive = false;
 
     MidiMessage _message;
+
+    SysExHandler _sysExHandler;
+    uint8_t _sysExData[SysExChunkSize];
+    uint8_t _sysExLength = 0;
+    bool _sysExFirst = false;
 };
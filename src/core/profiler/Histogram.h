@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+// Histogram with log2 spaced bins, used to collect timing distributions in us.
+// Bin 0 counts zero values, bin i counts values in [2^(i-1), 2^i), the last bin
+// also counts everything above.
+template<int Bins_>
+struct Histogram {
+    static constexpr int Bins = Bins_;
+
+    inline void add(uint32_t value) {
+        int bin = value == 0 ? 0 : 32 - __builtin_clz(value);
+        ++bins[bin < Bins ? bin : Bins - 1];
+    }
+
+    // returns the upper bound of the bin containing the given percentile (0..100)
+    uint32_t percentile(int percent) const {
+        uint32_t total = 0;
+        for (int i = 0; i < Bins; ++i) {
+            total += bins[i];
+        }
+        if (total == 0) {
+            return 0;
+        }
+
+        uint32_t threshold = (uint64_t(total) * percent + 99) / 100;
+        uint32_t count = 0;
+        for (int i = 0; i < Bins; ++i) {
+            count += bins[i];
+            if (count >= threshold) {
+                return 1 << i;
+            }
+        }
+        return 1 << (Bins - 1);
+    }
+
+    uint32_t bins[Bins];
+};
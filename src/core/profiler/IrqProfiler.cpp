@@ -0,0 +1,34 @@
+#include "IrqProfiler.h"
+
+#include "core/Debug.h"
+
+#include "os/os.h"
+
+#if CONFIG_ENABLE_IRQ_PROFILER
+
+uint32_t IrqProfiler::_start[int(Source::Last)];
+IrqProfiler::Stats IrqProfiler::_stats[int(Source::Last)];
+
+void IrqProfiler::reset() {
+    os::InterruptLock lock;
+    for (auto &stats : _stats) {
+        stats = {};
+    }
+}
+
+void IrqProfiler::dump() {
+    DBG("IRQ Profiler:");
+    DBG("---------------------------------------------");
+    for (int i = 0; i < int(Source::Last); ++i) {
+        const auto &stats = _stats[i];
+        DBG("  %-12s count=%u dur(max=%u p99<%u) lat(max=%u p99<%u) us",
+            sourceName(Source(i)),
+            unsigned(stats.count),
+            unsigned(stats.durationMax), unsigned(stats.duration.percentile(99)),
+            unsigned(stats.latencyMax), unsigned(stats.latency.percentile(99))
+        );
+    }
+    DBG("---------------------------------------------");
+}
+
+#endif // CONFIG_ENABLE_IRQ_PROFILER
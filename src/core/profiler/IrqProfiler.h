@@ -0,0 +1,94 @@
+#pragma once
+
+#include "SystemConfig.h"
+
+#include "Histogram.h"
+
+#include "ProfilerTimer.h"
+
+#include <cstdint>
+
+// Lightweight instrumentation of interrupt handlers (and other short driver
+// routines). Records the duration of each invocation and, for sources that
+// know when they were supposed to fire, the latency relative to that point
+// in time. Both are collected into log2 histograms in microseconds.
+class IrqProfiler {
+public:
+    enum class Source : uint8_t {
+        ClockTimer,
+        Dio,
+        Midi,
+        // transfers are not interrupt handlers: sd card transfers are polled in the
+        // file task, lcd transfers start in the ui task (and end in the dma interrupt),
+        // so their durations include time the task was preempted
+        SdCard,
+        Lcd,
+        Last
+    };
+
+    static const char *sourceName(Source source) {
+        switch (source) {
+        case Source::ClockTimer:    return "CLOCK TIMER";
+        case Source::Dio:           return "DIO";
+        case Source::Midi:          return "MIDI";
+        case Source::SdCard:        return "SDCARD XFER";
+        case Source::Lcd:           return "LCD XFER";
+        case Source::Last:          break;
+        }
+        return nullptr;
+    }
+
+    struct Stats {
+        uint32_t count;
+        uint32_t durationMax;
+        uint32_t latencyMax;
+        Histogram<12> duration;
+        Histogram<12> latency;
+    };
+
+#if CONFIG_ENABLE_IRQ_PROFILER
+
+    static inline void enter(Source source) {
+        _start[int(source)] = ProfilerTimer::us();
+    }
+
+    static inline void exit(Source source) {
+        auto &stats = _stats[int(source)];
+        uint32_t duration = ProfilerTimer::us() - _start[int(source)];
+        ++stats.count;
+        stats.durationMax = duration > stats.durationMax ? duration : stats.durationMax;
+        stats.duration.add(duration);
+    }
+
+    // record how late the source fired compared to its scheduled time
+    static inline void latency(Source source, uint32_t us) {
+        auto &stats = _stats[int(source)];
+        stats.latencyMax = us > stats.latencyMax ? us : stats.latencyMax;
+        stats.latency.add(us);
+    }
+
+    static const Stats &stats(Source source) { return _stats[int(source)]; }
+
+    static void reset();
+    static void dump();
+
+private:
+    static uint32_t _start[int(Source::Last)];
+    static Stats _stats[int(Source::Last)];
+
+#else // CONFIG_ENABLE_IRQ_PROFILER
+
+    static inline void enter(Source source) {}
+    static inline void exit(Source source) {}
+    static inline void latency(Source source, uint32_t us) {}
+
+    static const Stats &stats(Source source) {
+        static const Stats empty = {};
+        return empty;
+    }
+
+    static void reset() {}
+    static void dump() {}
+
+#endif // CONFIG_ENABLE_IRQ_PROFILER
+};
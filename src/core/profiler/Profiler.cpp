@@ -2,39 +2,163 @@
 
 #include "core/Debug.h"
 
+#include "drivers/Console.h"
+#include "os/os.h"
+#include "stb/stb_sprintf.h"
+
 #if CONFIG_ENABLE_PROFILER
 int Profiler::_numIntervals;
 int Profiler::_numCounters;
 Profiler::Interval *Profiler::_intervals[Profiler::MaxIntervals];
 Profiler::Counter *Profiler::_counters[Profiler::MaxCounters];
 
+Profiler::TimelineEvent Profiler::_timeline[Profiler::TimelineSize];
+uint32_t Profiler::_timelineWrite;
+uint32_t Profiler::_timelineCount;
+
+static constexpr uint16_t InvalidIndex = 0xffff;
+
+// events are assigned to the task they were recorded in, thread 0 is used for interrupt handlers
+static constexpr int MaxThreads = 8;
+static os::TaskHandle threadHandles[MaxThreads];
+static int numThreads;
+
+// needs to be called with interrupts disabled
+static uint8_t currentThread() {
+    if (os::inInterrupt()) {
+        return 0;
+    }
+    auto handle = os::this_task::handle();
+    for (int i = 0; i < numThreads; ++i) {
+        if (threadHandles[i] == handle) {
+            return i + 1;
+        }
+    }
+    if (numThreads < MaxThreads) {
+        threadHandles[numThreads++] = handle;
+        return numThreads;
+    }
+    // share the last thread if there are too many tasks
+    return MaxThreads;
+}
+
+// the console does not block when full, wait for it to drain before writing larger amounts of text
+static void waitConsole() {
+    while (Console::writable() < 128) {
+        os::delay(1);
+    }
+}
+
+void Profiler::Interval::record(uint32_t start, uint32_t duration) {
+    os::InterruptLock lock;
+
+    last = duration;
+    min = (count == 0 || duration < min) ? duration : min;
+    max = (count == 0 || duration > max) ? duration : max;
+    total += duration;
+    ++count;
+    histogram.add(duration);
+
+    recordEvent(*this, start, duration);
+}
+
 void Profiler::init() {
 }
 
+void Profiler::reset() {
+    os::InterruptLock lock;
+
+    for (int i = 0; i < _numIntervals; ++i) {
+        auto &interval = *_intervals[i];
+        interval.count = 0;
+        interval.last = 0;
+        interval.min = 0;
+        interval.max = 0;
+        interval.total = 0;
+        interval.histogram = {};
+    }
+    for (int i = 0; i < _numCounters; ++i) {
+        _counters[i]->count = 0;
+    }
+    _timelineWrite = 0;
+    _timelineCount = 0;
+}
+
 void Profiler::dump() {
     DBG("Profiler:");
     DBG("---------------------------------------------");
     if (_numIntervals > 0) {
-        DBG("Intervals:");
+        DBG("Intervals (us):");
         for (int i = 0; i < _numIntervals; ++i) {
             const auto &interval = *_intervals[i];
-            DBG("  %s: %lu us", interval.desc, interval.avg);
+            waitConsole();
+            DBG("  %s: count=%u min=%u mean=%u max=%u p50<%u p95<%u p99<%u",
+                interval.desc,
+                unsigned(interval.count),
+                unsigned(interval.min),
+                unsigned(interval.mean()),
+                unsigned(interval.max),
+                unsigned(interval.histogram.percentile(50)),
+                unsigned(interval.histogram.percentile(95)),
+                unsigned(interval.histogram.percentile(99))
+            );
         }
     }
     if (_numCounters > 0) {
         DBG("Counters:");
         for (int i = 0; i < _numCounters; ++i) {
             const auto &counter = *_counters[i];
-            DBG("  %s: %lu", counter.desc, counter.count);
+            waitConsole();
+            DBG("  %s: %u", counter.desc, unsigned(counter.count));
         }
     }
     DBG("---------------------------------------------");
 }
 
+void Profiler::dumpTrace() {
+    writeTrace([] (const char *str) {
+        waitConsole();
+        Console::write(str);
+    });
+    Console::write("\n");
+}
+
+void Profiler::writeTrace(WriteCallback write) {
+    // copy timeline to avoid holding interrupts disabled while writing
+    static TimelineEvent timeline[TimelineSize];
+    uint32_t count;
+    uint32_t first;
+    {
+        os::InterruptLock lock;
+        count = _timelineCount;
+        first = (_timelineWrite + TimelineSize - count) % TimelineSize;
+        for (uint32_t i = 0; i < count; ++i) {
+            timeline[i] = _timeline[(first + i) % TimelineSize];
+        }
+    }
+
+    char buf[128];
+    write("{\"traceEvents\":[\n");
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto &event = timeline[i];
+        stbsp_snprintf(buf, sizeof(buf), "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":0,\"tid\":%u}%s\n",
+            _intervals[event.interval]->desc,
+            unsigned(event.start),
+            unsigned(event.duration),
+            unsigned(event.thread),
+            i + 1 < count ? "," : ""
+        );
+        write(buf);
+    }
+    write("]}");
+}
+
 void Profiler::registerInterval(Interval *interval) {
     if (_numIntervals < MaxIntervals) {
+        interval->index = _numIntervals;
         _intervals[_numIntervals++] = interval;
     } else {
+        interval->index = InvalidIndex;
         DBG("Profiler: Too many profiler intervals!");
     }
 }
@@ -47,4 +171,16 @@ void Profiler::registerCounter(Counter *counter) {
     }
 }
 
+// needs to be called with interrupts disabled
+void Profiler::recordEvent(const Interval &interval, uint32_t start, uint32_t duration) {
+    if (interval.index == InvalidIndex) {
+        return;
+    }
+
+    // oldest events are overwritten when the timeline is full
+    _timeline[_timelineWrite] = { interval.index, currentThread(), start, duration };
+    _timelineWrite = (_timelineWrite + 1) % TimelineSize;
+    _timelineCount = _timelineCount < uint32_t(TimelineSize) ? _timelineCount + 1 : _timelineCount;
+}
+
 #endif // CONFIG_ENABLE_PROFILER
@@ -2,7 +2,11 @@
 
 #include "SystemConfig.h"
 
-#include "drivers/HighResolutionTimer.h"
+#include "Histogram.h"
+
+#include "ProfilerTimer.h"
+
+#include <functional>
 
 #include <cstdint>
 
@@ -10,26 +14,61 @@
 
 class Profiler {
 public:
+    typedef std::function<void(const char *)> WriteCallback;
+
     static void init();
+    static void reset();
+
+    // dump interval statistics and counters to the console
     static void dump();
 
+    // write the event timeline in chrome trace format (chrome://tracing)
+    static void dumpTrace();
+    static void writeTrace(WriteCallback write);
+
     struct Interval {
         Interval(const char *desc) : desc(desc) {
             registerInterval(this);
         }
 
         inline void begin() {
-            start = HighResolutionTimer::us();
+            start = ProfilerTimer::us();
         }
 
         inline void end() {
-            uint32_t end = HighResolutionTimer::us();
-            avg = end - start;
+            record(start, ProfilerTimer::us() - start);
         }
 
+        void record(uint32_t start, uint32_t duration);
+
+        uint32_t mean() const { return count > 0 ? total / count : 0; }
+
         const char *desc;
+        uint16_t index;
         uint32_t start;
-        uint32_t avg;
+        uint32_t count;
+        uint32_t last;
+        uint32_t min;
+        uint32_t max;
+        uint64_t total;
+        Histogram<16> histogram;
+    };
+
+    // Measures the lifetime of the scope. Scopes can be nested and also
+    // nest properly in the timeline.
+    struct Scope {
+        Scope(Interval &interval) :
+            _interval(interval),
+            _start(ProfilerTimer::us())
+        {}
+
+        ~Scope() {
+            _interval.record(_start, ProfilerTimer::us() - _start);
+        }
+
+    private:
+        Interval &_interval;
+        uint32_t _start;
     };
 
     struct Counter {
@@ -46,16 +85,29 @@ public:
     };
 
 private:
-    static const int MaxIntervals = 16;
+    static const int MaxIntervals = 32;
     static const int MaxCounters = 16;
+    static const int TimelineSize = CONFIG_PROFILER_TIMELINE_SIZE;
+
+    struct TimelineEvent {
+        uint16_t interval;
+        uint8_t thread;
+        uint32_t start;
+        uint32_t duration;
+    };
 
     static void registerInterval(Interval *interval);
     static void registerCounter(Counter *counter);
+    static void recordEvent(const Interval &interval, uint32_t start, uint32_t duration);
 
     static int _numIntervals;
     static int _numCounters;
     static Interval *_intervals[MaxIntervals];
     static Counter *_counters[MaxCounters];
+
+    static TimelineEvent _timeline[TimelineSize];
+    static uint32_t _timelineWrite;
+    static uint32_t _timelineCount;
 };
 
 # define PROFILER_INTERVAL(_name_, _desc_) \
@@ -65,24 +117,35 @@ private:
 # define PROFILER_INTERVAL_END(_name_) \
     _name_##_profiler_interval.end();
 
+# define PROFILER_SCOPE(_name_, _desc_) \
+    static Profiler::Interval _name_##_profiler_interval(_desc_); \
+    Profiler::Scope _name_##_profiler_scope(_name_##_profiler_interval);
+
 # define PROFILER_COUNTER(_name_, _desc_) \
     static Profiler::Counter _name_##_profiler_counter(_desc_);
-# define PROFILER_COUNTER_ADD(_num_) \
+# define PROFILER_COUNTER_ADD(_name_, _num_) \
     _name_##_profiler_counter.add(_num_);
 
 #else // CONFIG_ENABLE_PROFILER
 
 class Profiler {
 public:
+    typedef std::function<void(const char *)> WriteCallback;
+
     static void init() {}
+    static void reset() {}
     static void dump() {}
+    static void dumpTrace() {}
+    static void writeTrace(WriteCallback write) {}
 };
 
 # define PROFILER_INTERVAL(_name_, _desc_)
 # define PROFILER_INTERVAL_BEGIN(_name_)
 # define PROFILER_INTERVAL_END(_name_)
 
+# define PROFILER_SCOPE(_name_, _desc_)
+
 # define PROFILER_COUNTER(_name_, _desc_)
-# define PROFILER_COUNTER_ADD(_num_)
+# define PROFILER_COUNTER_ADD(_name_, _num_)
 
 #endif // CONFIG_ENABLE_PROFILER
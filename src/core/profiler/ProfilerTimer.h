@@ -0,0 +1,18 @@
+#pragma once
+
+#include "drivers/HighResolutionTimer.h"
+
+#include <cstdint>
+
+// Time base (us) of the profilers. The simulator measures host time, its
+// HighResolutionTimer follows the simulated time which does not advance while
+// code is running.
+struct ProfilerTimer {
+    static inline uint32_t us() {
+#ifdef PLATFORM_SIM
+        return HighResolutionTimer::hostUs();
+#else
+        return HighResolutionTimer::us();
+#endif
+    }
+};
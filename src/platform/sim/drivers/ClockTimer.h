@@ -2,6 +2,8 @@
 
 #include "sim/Simulator.h"
 
+#include "core/profiler/IrqProfiler.h"
+
 #include <cstdint>
 
 class ClockTimer {
@@ -53,10 +55,17 @@ private:
         double ticks = _simulator.ticks();
         while (ticks - _lastTicks >= _periodTicks) {
             _lastTicks += _periodTicks;
+            // ticks are only dispatched at simulator step resolution, record how late they fire
+            IrqProfiler::enter(IrqProfiler::Source::ClockTimer);
+            IrqProfiler::latency(IrqProfiler::Source::ClockTimer, uint32_t((ticks - _lastTicks) * 1000.0));
+            // the listener sees the time the tick was due, not the step it is dispatched in
+            _simulator.setEventTime(_lastTicks);
             if (_listener) {
                 _listener->onClockTimerTick();
             }
+            IrqProfiler::exit(IrqProfiler::Source::ClockTimer);
         }
+        _simulator.resetEventTime();
     }
 
     sim::Simulator &_simulator;
@@ -24,6 +24,14 @@ void Console::write(const std::string &s) {
     }
 }
 
+void Console::writeRaw(const uint8_t *data, size_t length) {
+    std::cout.write(reinterpret_cast<const char *>(data), length);
+}
+
+void Console::flush() {
+    std::cout.flush();
+}
+
 void Console::send(char c) {
     std::cout << c;
 }
@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include <cstdint>
+
 class Console {
 public:
     static void write(char c);
@@ -9,6 +11,13 @@ public:
     static void write(const char *s, size_t length);
     static void write(const std::string &s);
 
+    static void writeRaw(const uint8_t *data, size_t length);
+
+    static void flush();
+
+    static size_t writable() { return SIZE_MAX; }
+    static uint32_t dropped() { return 0; }
+
 private:
     static void send(char c);
 };
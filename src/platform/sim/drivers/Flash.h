@@ -2,12 +2,50 @@
 
 #include "SystemConfig.h"
 
+#include <vector>
+
 #include <cstdint>
+#include <cstring>
 
+// Emulates the internal flash of the STM32F405 (1024K in 12 sectors) in memory.
+// Like the real flash, erasing sets all bits of a sector and programming can
+// only clear bits.
 class Flash {
 public:
+    static constexpr uint32_t BaseAddress = 0x08000000;
+    static constexpr uint32_t Size = 1024 * 1024;
+
     static void unlock() {}
     static void lock() {}
-    static void eraseSector(uint32_t sector) {}
-    static void program(uint32_t address, uint32_t data) {}
+
+    static void eraseSector(uint32_t sector) {
+        std::memset(&memory()[sectorAddress(sector) - BaseAddress], 0xff, sectorSize(sector));
+    }
+
+    static void program(uint32_t address, uint32_t data) {
+        uint8_t *dst = &memory()[address - BaseAddress];
+        for (int i = 0; i < 4; ++i) {
+            dst[i] &= (data >> (i * 8)) & 0xff;
+        }
+    }
+
+    static void read(uint32_t address, void *data, size_t len) {
+        std::memcpy(data, &memory()[address - BaseAddress], len);
+    }
+
+    static uint32_t sectorAddress(uint32_t sector) {
+        return sector < 4 ? BaseAddress + sector * 0x4000 :
+               sector < 5 ? BaseAddress + 0x10000 :
+                            BaseAddress + 0x20000 + (sector - 5) * 0x20000;
+    }
+
+    static uint32_t sectorSize(uint32_t sector) {
+        return sector < 4 ? 0x4000 : sector < 5 ? 0x10000 : 0x20000;
+    }
+
+private:
+    static std::vector<uint8_t> &memory() {
+        static std::vector<uint8_t> memory(Size, 0xff);
+        return memory;
+    }
 };
@@ -1,23 +1,34 @@
 #pragma once
 
+#include "sim/Simulator.h"
+
 #include <chrono>
 
+#include <cmath>
 #include <cstdint>
 
-namespace detail {
-    static std::chrono::time_point<std::chrono::high_resolution_clock> start;
-}
-
+// Follows the simulated time, so runs are reproducible independent of the
+// speed of the host.
 class HighResolutionTimer {
 public:
     static void init() {
-        detail::start = std::chrono::high_resolution_clock::now();
+        start();
     }
 
     static uint32_t us() {
-        auto current = std::chrono::high_resolution_clock::now();
+        return uint32_t(uint64_t(std::llround(sim::Simulator::instance().time() * 1000.0)));
+    }
 
-        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::duration<double>(current - detail::start)).count();
+    // Host time, used for profiling and benchmarks (simulated time does not
+    // advance while code is running).
+    static uint32_t hostUs() {
+        auto current = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(current - start()).count();
     }
 
+private:
+    static std::chrono::steady_clock::time_point start() {
+        static auto start = std::chrono::steady_clock::now();
+        return start;
+    }
 };
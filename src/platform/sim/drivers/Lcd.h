@@ -5,6 +5,8 @@
 
 #include "SystemConfig.h"
 
+#include "core/profiler/IrqProfiler.h"
+
 #include <cstdint>
 #include <cstring>
 
@@ -20,8 +22,10 @@ public:
     void init() {}
 
     void draw(uint8_t *frameBuffer) {
+        IrqProfiler::enter(IrqProfiler::Source::Lcd);
         std::memcpy(_frameBuffer.data(), frameBuffer, _frameBuffer.size());
         _simulator.writeLcd(_frameBuffer);
+        IrqProfiler::exit(IrqProfiler::Source::Lcd);
     }
 
 private:
@@ -1,13 +1,16 @@
 #pragma once
 
 #include "core/midi/MidiMessage.h"
+#include "core/midi/MidiParser.h"
 
 #include "sim/Simulator.h"
 
 #include <functional>
 #include <deque>
 #include <memory>
+#include <algorithm>
 
+#include <cmath>
 #include <cstdint>
 
 class UsbMidi : private sim::TargetInputHandler {
@@ -15,6 +18,9 @@ public:
     typedef std::function<void(uint16_t vendorId, uint16_t productId)> ConnectHandler;
     typedef std::function<void()> DisconnectHandler;
     typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef MidiParser::SysExHandler SysExHandler;
+
+    static constexpr size_t SysExTxBufferSize = 256;
 
     UsbMidi() :
         _simulator(sim::Simulator::instance())
@@ -25,11 +31,65 @@ public:
     void init() {}
 
     bool send(const MidiMessage &message) {
+        // hold back non real-time messages while a streamed SysEx message is in progress
+        if (_txSysExOpen && !message.isRealTimeMessage()) {
+            if (_txHeldQueue.size() >= TxQueueSize) {
+                return false;
+            }
+            _txHeldQueue.emplace_back(message);
+            return true;
+        }
         _simulator.writeMidiOutput(sim::MidiEvent::makeMessage(1, message));
         return true;
     }
 
+    bool sendSysEx(const uint8_t *data, size_t length) {
+        if (length < 2 || data[0] != MidiMessage::SystemExclusive || data[length - 1] != MidiMessage::EndOfExclusive ||
+            _txSysExOpen || txSysExWritable() < length) {
+            return false;
+        }
+        writeSysEx(data, length);
+        return true;
+    }
+
+    bool beginSysEx() {
+        if (_txSysExOpen || txSysExWritable() < 1) {
+            return false;
+        }
+        const uint8_t start = MidiMessage::SystemExclusive;
+        writeSysEx(&start, 1);
+        _txSysExOpen = true;
+        return true;
+    }
+
+    size_t appendSysEx(const uint8_t *data, size_t length) {
+        if (!_txSysExOpen) {
+            return 0;
+        }
+        length = std::min(length, txSysExWritable());
+        writeSysEx(data, length);
+        return length;
+    }
+
+    bool endSysEx() {
+        if (!_txSysExOpen || txSysExWritable() < 1) {
+            return false;
+        }
+        const uint8_t end = MidiMessage::EndOfExclusive;
+        writeSysEx(&end, 1);
+        _txSysExOpen = false;
+        while (!_txHeldQueue.empty()) {
+            _simulator.writeMidiOutput(sim::MidiEvent::makeMessage(1, _txHeldQueue.front()));
+            _txHeldQueue.pop_front();
+        }
+        return true;
+    }
+
     bool recv(MidiMessage *message) {
+        while (!_recvSysExQueue.empty()) {
+            _sysExParser.feed(_recvSysExQueue.front());
+            _recvSysExQueue.pop_front();
+        }
         if (!_recvQueue.empty()) {
             *message = _recvQueue.front();
             _recvQueue.pop_front();
@@ -50,9 +110,28 @@ public:
         _recvFilter = filter;
     }
 
+    void setSysExHandler(SysExHandler handler) {
+        _sysExParser.setSysExHandler(handler);
+    }
+
     uint32_t rxOverflow() const { return 0; }
 
 private:
+    // emulate the transmit buffer, one USB MIDI packet (3 bytes) is sent per millisecond
+    size_t txSysExWritable() {
+        double time = _simulator.ticks();
+        _txSysExPending = std::max(0.0, _txSysExPending - (time - _txSysExTime) * TxBytesPerMs);
+        _txSysExTime = time;
+        return SysExTxBufferSize - std::min(size_t(std::ceil(_txSysExPending)), SysExTxBufferSize);
+    }
+
+    void writeSysEx(const uint8_t *data, size_t length) {
+        _txSysExPending += length;
+        for (size_t i = 0; i < length; i += sim::MidiEvent::SysExPacketSize) {
+            _simulator.writeMidiOutput(sim::MidiEvent::makeSysEx(1, &data[i], length - i));
+        }
+    }
+
     void writeMidiInput(sim::MidiEvent event) {
         if (event.port == 1) {
             switch (event.kind) {
@@ -71,14 +150,27 @@ private:
                     _recvQueue.emplace_back(event.message);
                 }
                 break;
+            case sim::MidiEvent::SysEx:
+                _recvSysExQueue.insert(_recvSysExQueue.end(), event.sysEx.data, event.sysEx.data + event.sysEx.length);
+                break;
             }
         }
     }
 
+    static constexpr size_t TxQueueSize = 128;
+    static constexpr double TxBytesPerMs = 3.0;
+
     ConnectHandler _connectHandler;
     DisconnectHandler _disconnectHandler;
     RecvFilter _recvFilter;
 
     sim::Simulator &_simulator;
     std::deque<MidiMessage> _recvQueue;
+
+    std::deque<uint8_t> _recvSysExQueue;
+    MidiParser _sysExParser;
+    double _txSysExPending = 0.0;
+    double _txSysExTime = 0.0;
+    bool _txSysExOpen = false;
+    std::deque<MidiMessage> _txHeldQueue;
 };
@@ -40,6 +40,8 @@ namespace os {
     inline void resume(TaskHandle handle) {}
     inline void resumeFromISR(TaskHandle handle) {}
 
+    inline bool inInterrupt() { return false; }
+
     namespace this_task {
 
         inline TaskHandle handle() { return -1; }
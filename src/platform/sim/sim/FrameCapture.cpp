@@ -0,0 +1,146 @@
+#include "FrameCapture.h"
+
+#include "libs/stb/stb_image_write.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace sim {
+
+static bool createDirectory(const std::string &path) {
+#ifdef _WIN32
+    int result = _mkdir(path.c_str());
+#else
+    int result = mkdir(path.c_str(), 0755);
+#endif
+    return result == 0 || errno == EEXIST;
+}
+
+FrameCapture::FrameCapture(Simulator &simulator, const std::string &path, Format format, bool leds) :
+    _simulator(simulator),
+    _path(path),
+    _format(format),
+    _leds(leds),
+    _width(TargetConfig::LcdWidth),
+    _height(TargetConfig::LcdHeight + (leds ? LedSize + LedSpacing : 0)),
+    _image(_width * _height * 3, 0)
+{
+    switch (_format) {
+    case Format::Png:
+        if (!createDirectory(_path)) {
+            fail("cannot create directory " + _path);
+        }
+        _timestamps.open(_path + "/frames.txt");
+        break;
+    case Format::Raw:
+        _video.open(_path, std::ios::binary);
+        if (!_video) {
+            fail("cannot open " + _path);
+        }
+        _timestamps.open(_path + ".txt");
+        break;
+    }
+    _timestamps << "# timestamp format v2" << std::endl;
+    if (!_timestamps) {
+        fail("cannot write timestamps");
+    }
+
+    _simulator.registerTargetOutputObserver(this);
+}
+
+FrameCapture::~FrameCapture() {
+    close();
+}
+
+void FrameCapture::close() {
+    if (!_open) {
+        return;
+    }
+
+    _simulator.unregisterTargetOutputObserver(this);
+    _video.close();
+    _timestamps.close();
+    _open = false;
+}
+
+void FrameCapture::writeLcd(const FrameBuffer &frameBuffer) {
+    ++_frames;
+
+    render(frameBuffer, _simulator.targetState().led);
+    if (_image == _lastImage) {
+        return;
+    }
+    _lastImage = _image;
+
+    writeFrame();
+}
+
+void FrameCapture::render(const FrameBuffer &frameBuffer, const LedState &ledState) {
+    uint8_t *dst = _image.data();
+
+    for (int i = 0; i < TargetConfig::LcdWidth * TargetConfig::LcdHeight; ++i) {
+        uint8_t value = std::min(uint8_t(15), frameBuffer[i]) * 17;
+        *dst++ = value;
+        *dst++ = value;
+        *dst++ = value;
+    }
+
+    if (_leds) {
+        // one block per led below the lcd, in led index order
+        for (int y = 0; y < LedSpacing; ++y) {
+            dst = std::fill_n(dst, _width * 3, 0);
+        }
+        for (int y = 0; y < LedSize; ++y) {
+            for (int x = 0; x < _width; ++x) {
+                int index = x / LedSize;
+                bool inside = index < LedState::Count && x % LedSize < LedSize - LedSpacing;
+                bool red = inside && ledState.state[index * 2];
+                bool green = inside && ledState.state[index * 2 + 1];
+                *dst++ = red ? 0xff : 0;
+                *dst++ = green ? 0xff : 0;
+                *dst++ = 0;
+            }
+        }
+    }
+}
+
+void FrameCapture::writeFrame() {
+    switch (_format) {
+    case Format::Png: {
+        std::stringstream ss;
+        ss << _path << "/frame-" << std::setw(6) << std::setfill('0') << _capturedFrames << ".png";
+        if (!stbi_write_png(ss.str().c_str(), _width, _height, 3, _image.data(), _width * 3)) {
+            fail("cannot write " + ss.str());
+        }
+        break;
+    }
+    case Format::Raw:
+        _video.write(reinterpret_cast<const char *>(_image.data()), _image.size());
+        if (!_video) {
+            fail("cannot write " + _path);
+        }
+        break;
+    }
+
+    _timestamps << uint32_t(_simulator.ticks()) << std::endl;
+    ++_capturedFrames;
+}
+
+void FrameCapture::fail(const std::string &message) {
+    if (!_failed) {
+        std::cerr << "Frame capture failed: " << message << std::endl;
+        _failed = true;
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Simulator.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace sim {
+
+// Captures LCD frames (and optionally the LEDs, drawn as a strip below the LCD)
+// at the simulated time they are written by the target. Identical consecutive
+// frames are only captured once. Frames are written as RGB images, either as a
+// PNG image sequence into a directory or as a raw video stream into a file.
+// The simulated time of each captured frame is written to a timestamp file
+// (mkvmerge timestamp format v2, frames.txt or <file>.txt for raw video).
+// Raw video can be encoded with:
+//   ffmpeg -f rawvideo -pix_fmt rgb24 -s 256x64 -r 50 -i lcd.raw lcd.mp4
+// (use a height of 73 when capturing LEDs).
+// The PNG output directory is created if it does not exist. Failing to open or
+// write the output is reported on stderr (once) and by failed().
+class FrameCapture : public TargetOutputHandler {
+public:
+    enum class Format {
+        Png,
+        Raw,
+    };
+
+    FrameCapture(Simulator &simulator, const std::string &path, Format format, bool leds = false);
+    ~FrameCapture();
+
+    void close();
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    // number of frames written by the target and number of captured (unique) frames
+    uint32_t frames() const { return _frames; }
+    uint32_t capturedFrames() const { return _capturedFrames; }
+
+    // true if the output could not be opened or a frame could not be written
+    bool failed() const { return _failed; }
+
+    // TargetOutputHandler
+    void writeLcd(const FrameBuffer &frameBuffer) override;
+
+private:
+    void render(const FrameBuffer &frameBuffer, const LedState &ledState);
+    void writeFrame();
+    void fail(const std::string &message);
+
+    static constexpr int LedSize = 8;
+    static constexpr int LedSpacing = 1;
+
+    Simulator &_simulator;
+    std::string _path;
+    Format _format;
+    bool _leds;
+    bool _open = true;
+    bool _failed = false;
+
+    int _width;
+    int _height;
+    std::vector<uint8_t> _image;
+    std::vector<uint8_t> _lastImage;
+
+    std::ofstream _video;
+    std::ofstream _timestamps;
+
+    uint32_t _frames = 0;
+    uint32_t _capturedFrames = 0;
+};
+
+} // namespace sim
@@ -2,6 +2,9 @@
 
 #include "core/midi/MidiMessage.h"
 
+#include <algorithm>
+
+#include <cstddef>
 #include <cstdint>
 
 namespace sim {
@@ -11,8 +14,12 @@ struct MidiEvent {
         Connect,
         Disconnect,
         Message,
+        SysEx,
     };
 
+    // SysEx messages are transferred in packets of up to 3 bytes (similar to USB MIDI)
+    static constexpr size_t SysExPacketSize = 3;
+
     int kind;
     int port;
     union {
@@ -21,6 +28,10 @@ struct MidiEvent {
             uint16_t vendorId;
             uint16_t productId;
         } connect;
+        struct {
+            uint8_t data[SysExPacketSize];
+            uint8_t length;
+        } sysEx;
     };
 
     MidiEvent() : message() {}
@@ -45,6 +56,13 @@ struct MidiEvent {
         event.message = message;
         return event;
     }
+
+    static MidiEvent makeSysEx(int port, const uint8_t *data, size_t length) {
+        MidiEvent event(SysEx, port);
+        event.sysEx.length = std::min(length, SysExPacketSize);
+        std::copy(data, data + event.sysEx.length, event.sysEx.data);
+        return event;
+    }
 };
 
 } // namespace sim
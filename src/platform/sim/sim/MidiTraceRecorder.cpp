@@ -0,0 +1,35 @@
+#include "MidiTraceRecorder.h"
+
+#include <fstream>
+
+namespace sim {
+
+MidiTraceRecorder::MidiTraceRecorder(Simulator &simulator, TargetTrace &targetTrace) :
+    _simulator(simulator),
+    _targetTrace(targetTrace),
+    _start(std::chrono::steady_clock::now())
+{
+    _simulator.registerTargetInputObserver(this);
+}
+
+MidiTraceRecorder::~MidiTraceRecorder() {
+    _simulator.unregisterTargetInputObserver(this);
+}
+
+bool MidiTraceRecorder::saveHostTimes(const std::string &filename) const {
+    std::ofstream ofs(filename);
+    const auto &items = _targetTrace.midiInput.items();
+    for (size_t i = 0; i < items.size() && i < _hostTimes.size(); ++i) {
+        ofs << items[i].first << " " << _hostTimes[i] << "\n";
+    }
+    ofs.close();
+    return bool(ofs);
+}
+
+void MidiTraceRecorder::writeMidiInput(MidiEvent event) {
+    // inputs written between two steps are first seen by the next step
+    _targetTrace.midiInput.write(uint32_t(_simulator.ticks()), event);
+    _hostTimes.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count());
+}
+
+} // namespace sim
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Simulator.h"
+#include "TargetTrace.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace sim {
+
+// Captures the MIDI input of the simulator (e.g. a live rtmidi session) into
+// the MIDI input trace of a target trace. Events are recorded with the tick
+// they are seen by the target, so the trace can be fed back into a simulator
+// with TargetTracePlayer to reproduce the session deterministically.
+// The host (wall-clock) time of every event is recorded next to the tick, so
+// the jitter between host and simulated time can be analyzed.
+class MidiTraceRecorder : public TargetInputHandler {
+public:
+    MidiTraceRecorder(Simulator &simulator, TargetTrace &targetTrace);
+    ~MidiTraceRecorder();
+
+    TargetTrace &targetTrace() { return _targetTrace; }
+
+    // host time (us since the recorder was created) of each event in the MIDI input trace
+    const std::vector<uint64_t> &hostTimes() const { return _hostTimes; }
+
+    // writes a text file with one "<tick> <host time us>" line per event
+    bool saveHostTimes(const std::string &filename) const;
+
+    // TargetInputHandler
+    virtual void writeMidiInput(MidiEvent event) override;
+
+private:
+    Simulator &_simulator;
+    TargetTrace &_targetTrace;
+    std::chrono::steady_clock::time_point _start;
+    std::vector<uint64_t> _hostTimes;
+};
+
+} // namespace sim
@@ -1,4 +1,5 @@
 #include "Simulator.h"
+#include "TargetUtils.h"
 
 #include "libs/stb/stb_image_write.h"
 
@@ -57,8 +58,7 @@ void Simulator::rotateEncoder(int direction) {
 }
 
 void Simulator::setAdc(int channel, float voltage) {
-    float normalized = std::max(0.f, std::min(1.f, voltage * 0.1f + 0.5f));
-    writeAdc(channel, uint16_t(std::floor(0xffff - 0xffff * normalized)));
+    writeAdc(channel, voltageToAdc(voltage));
 }
 
 void Simulator::setDio(int pin, bool state) {
@@ -69,6 +69,12 @@ void Simulator::sendMidi(int port, const MidiMessage &message) {
     writeMidiInput(MidiEvent::makeMessage(port, message));
 }
 
+void Simulator::sendSysEx(int port, const std::vector<uint8_t> &data) {
+    for (size_t i = 0; i < data.size(); i += MidiEvent::SysExPacketSize) {
+        writeMidiInput(MidiEvent::makeSysEx(port, &data[i], data.size() - i));
+    }
+}
+
 void Simulator::screenshot(const std::string &filename) {
     std::unique_ptr<uint8_t[]> pixelBuffer(new uint8_t[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT]);
 
@@ -103,6 +109,18 @@ void Simulator::registerTargetOutputObserver(TargetOutputHandler *observer) {
     _targetOutputObservers.emplace_back(observer);
 }
 
+void Simulator::unregisterTargetTickObserver(TargetTickHandler *observer) {
+    _targetTickObservers.erase(std::remove(_targetTickObservers.begin(), _targetTickObservers.end(), observer), _targetTickObservers.end());
+}
+
+void Simulator::unregisterTargetInputObserver(TargetInputHandler *observer) {
+    _targetInputObservers.erase(std::remove(_targetInputObservers.begin(), _targetInputObservers.end(), observer), _targetInputObservers.end());
+}
+
+void Simulator::unregisterTargetOutputObserver(TargetOutputHandler *observer) {
+    _targetOutputObservers.erase(std::remove(_targetOutputObservers.begin(), _targetOutputObservers.end(), observer), _targetOutputObservers.end());
+}
+
 // TargetInputHandler
 
 void Simulator::writeButton(int index, bool pressed) {
@@ -198,6 +216,7 @@ void Simulator::step() {
     _target.update();
 
     _tick += 1;
+    _time = _tick;
 }
 
 } // namespace sim
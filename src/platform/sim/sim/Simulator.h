@@ -25,6 +25,7 @@ public:
     void setAdc(int channel, float voltage);
     void setDio(int pin, bool state);
     void sendMidi(int port, const MidiMessage &message);
+    void sendSysEx(int port, const std::vector<uint8_t> &data);
 
     void screenshot(const std::string &filename);
 
@@ -32,6 +33,13 @@ public:
 
     double ticks();
 
+    // Simulated time (ms) with sub-ms resolution. Equals ticks(), except while
+    // drivers dispatch events that were due in between two steps (i.e. timer
+    // interrupts), these are processed at their exact time.
+    double time() const { return _time; }
+    void setEventTime(double time) { _time = time; }
+    void resetEventTime() { _time = _tick; }
+
     typedef std::function<void()> UpdateCallback;
 
     void addUpdateCallback(UpdateCallback callback);
@@ -41,6 +49,9 @@ public:
     void registerTargetTickObserver(TargetTickHandler *observer);
     void registerTargetInputObserver(TargetInputHandler *observer);
     void registerTargetOutputObserver(TargetOutputHandler *observer);
+    void unregisterTargetTickObserver(TargetTickHandler *observer);
+    void unregisterTargetInputObserver(TargetInputHandler *observer);
+    void unregisterTargetOutputObserver(TargetOutputHandler *observer);
 
     // TargetInputHandler
     void writeButton(int index, bool pressed) override;
@@ -66,6 +77,7 @@ private:
     bool _targetCreated = false;
 
     uint32_t _tick = 0;
+    double _time = 0.0;
 
     std::vector<TargetTickHandler *> _targetTickObservers;
     std::vector<TargetInputHandler *> _targetInputObservers;
@@ -0,0 +1,237 @@
+#include "SimulatorThread.h"
+
+#include <chrono>
+
+#include <cmath>
+
+namespace sim {
+
+// ----------------------------------------------------------------------------
+// Relay
+// ----------------------------------------------------------------------------
+
+// Observes the simulator on the simulator thread and queues all events.
+class SimulatorThread::Relay : public TargetInputHandler, public TargetOutputHandler {
+public:
+    Relay(SimulatorThread &thread) :
+        _thread(thread)
+    {}
+
+    // TargetInputHandler
+    void writeButton(int index, bool pressed) override {
+        _thread.pushEvent(Event::Button, index, pressed);
+    }
+
+    void writeEncoder(EncoderEvent event) override {
+        _thread.pushEvent(Event::Encoder, 0, int(event));
+    }
+
+    void writeAdc(int channel, uint16_t value) override {
+        _thread.pushEvent(Event::Adc, channel, value);
+    }
+
+    void writeDigitalInput(int pin, bool value) override {
+        _thread.pushEvent(Event::DigitalInput, pin, value);
+    }
+
+    void writeMidiInput(MidiEvent event) override {
+        _thread.pushEvent(Event::MidiInput, 0, 0, event);
+    }
+
+    // TargetOutputHandler
+    void writeLed(int index, bool red, bool green) override {
+        _thread.pushEvent(Event::Led, index, (red ? 1 : 0) | (green ? 2 : 0));
+    }
+
+    void writeGateOutput(int channel, bool value) override {
+        _thread.pushEvent(Event::GateOutput, channel, value);
+    }
+
+    void writeDac(int channel, uint16_t value) override {
+        _thread.pushEvent(Event::Dac, channel, value);
+    }
+
+    void writeDigitalOutput(int pin, bool value) override {
+        _thread.pushEvent(Event::DigitalOutput, pin, value);
+    }
+
+    void writeLcd(const FrameBuffer &frameBuffer) override {
+        _thread.pushFrame(frameBuffer);
+    }
+
+    void writeMidiOutput(MidiEvent event) override {
+        _thread.pushEvent(Event::MidiOutput, 0, 0, event);
+    }
+
+private:
+    SimulatorThread &_thread;
+};
+
+// ----------------------------------------------------------------------------
+// SimulatorThread
+// ----------------------------------------------------------------------------
+
+SimulatorThread::SimulatorThread(Simulator &simulator, TimeSource timeSource) :
+    _simulator(simulator),
+    _timeSource(timeSource),
+    _relay(new Relay(*this))
+{
+    _simulator.registerTargetInputObserver(_relay.get());
+    _simulator.registerTargetOutputObserver(_relay.get());
+}
+
+SimulatorThread::~SimulatorThread() {
+    stop();
+
+    _simulator.unregisterTargetInputObserver(_relay.get());
+    _simulator.unregisterTargetOutputObserver(_relay.get());
+}
+
+void SimulatorThread::start() {
+    if (_running) {
+        return;
+    }
+
+    _tick = uint32_t(std::floor(_timeSource()));
+    _running = true;
+    _thread = std::thread([this] () { run(); });
+}
+
+void SimulatorThread::stop() {
+    if (!_running) {
+        return;
+    }
+
+    _running = false;
+    _thread.join();
+}
+
+void SimulatorThread::post(Command command) {
+    if (!_commands.push([&command] (Command &entry) { entry = std::move(command); })) {
+        ++_dropped;
+    }
+}
+
+void SimulatorThread::poll(TargetInputHandler &inputHandler, TargetOutputHandler &outputHandler) {
+    while (!_events.empty()) {
+        const auto &event = _events.front();
+        _eventTick = event.tick;
+
+        switch (event.kind) {
+        case Event::Button:
+            inputHandler.writeButton(event.index, event.value);
+            break;
+        case Event::Encoder:
+            inputHandler.writeEncoder(EncoderEvent(event.value));
+            break;
+        case Event::Adc:
+            inputHandler.writeAdc(event.index, event.value);
+            break;
+        case Event::DigitalInput:
+            inputHandler.writeDigitalInput(event.index, event.value);
+            break;
+        case Event::MidiInput:
+            inputHandler.writeMidiInput(event.midi);
+            break;
+        case Event::Led:
+            outputHandler.writeLed(event.index, event.value & 1, event.value & 2);
+            break;
+        case Event::GateOutput:
+            outputHandler.writeGateOutput(event.index, event.value);
+            break;
+        case Event::Dac:
+            outputHandler.writeDac(event.index, event.value);
+            break;
+        case Event::DigitalOutput:
+            outputHandler.writeDigitalOutput(event.index, event.value);
+            break;
+        case Event::Lcd:
+            // only pass on the most recent frame
+            if (!_frames.empty()) {
+                while (!_frames.empty()) {
+                    _frame = _frames.front();
+                    _frames.pop();
+                }
+                outputHandler.writeLcd(_frame);
+            }
+            break;
+        case Event::MidiOutput:
+            outputHandler.writeMidiOutput(event.midi);
+            break;
+        }
+
+        _events.pop();
+    }
+}
+
+// TargetInputHandler
+
+void SimulatorThread::writeButton(int index, bool pressed) {
+    post([=] (Simulator &simulator) { simulator.writeButton(index, pressed); });
+}
+
+void SimulatorThread::writeEncoder(EncoderEvent event) {
+    post([=] (Simulator &simulator) { simulator.writeEncoder(event); });
+}
+
+void SimulatorThread::writeAdc(int channel, uint16_t value) {
+    post([=] (Simulator &simulator) { simulator.writeAdc(channel, value); });
+}
+
+void SimulatorThread::writeDigitalInput(int pin, bool value) {
+    post([=] (Simulator &simulator) { simulator.writeDigitalInput(pin, value); });
+}
+
+void SimulatorThread::writeMidiInput(MidiEvent event) {
+    post([=] (Simulator &simulator) { simulator.writeMidiInput(event); });
+}
+
+void SimulatorThread::run() {
+    auto runCommands = [this] () {
+        while (!_commands.empty()) {
+            _commands.front()(_simulator);
+            _commands.front() = nullptr;
+            _commands.pop();
+        }
+    };
+
+    while (_running) {
+        uint32_t currentTick = uint32_t(std::floor(_timeSource()));
+
+        // skip ahead if we cannot keep up with real time
+        if (currentTick > _tick + MaxCatchUp) {
+            _tick = currentTick - MaxCatchUp;
+        }
+
+        runCommands();
+        while (_tick < currentTick) {
+            _simulator.wait(1);
+            ++_tick;
+            runCommands();
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+}
+
+void SimulatorThread::pushEvent(Event::Kind kind, int index, int value, MidiEvent midi) {
+    bool pushed = _events.push([&] (Event &event) {
+        event.kind = kind;
+        event.tick = _tick;
+        event.index = index;
+        event.value = value;
+        event.midi = midi;
+    });
+    if (!pushed) {
+        ++_dropped;
+    }
+}
+
+void SimulatorThread::pushFrame(const FrameBuffer &frameBuffer) {
+    // drop frame if owner is behind, a newer one will follow
+    if (_frames.push([&] (FrameBuffer &entry) { entry = frameBuffer; })) {
+        pushEvent(Event::Lcd, 0, 0);
+    }
+}
+
+} // namespace sim
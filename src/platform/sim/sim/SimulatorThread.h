@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Simulator.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <cstdint>
+
+namespace sim {
+
+// Runs the simulator on its own thread, advancing it in real time. Inputs are
+// forwarded to the simulator thread and all target events are queued back to
+// be handled on the owning thread by calling poll(), so the owner never blocks
+// the simulated target (and vice versa).
+// In the WebAssembly build (with pthreads) the simulator thread is a web worker
+// and the queues live in the shared wasm memory (SharedArrayBuffer).
+class SimulatorThread : public TargetInputHandler {
+public:
+    typedef std::function<double()> TimeSource;
+    typedef std::function<void(Simulator &simulator)> Command;
+
+    SimulatorThread(Simulator &simulator, TimeSource timeSource);
+    ~SimulatorThread();
+
+    void start();
+    void stop();
+
+    bool running() const { return _running; }
+
+    // run command on the simulator thread before the next step
+    void post(Command command);
+
+    // pass target events queued by the simulator thread to the handlers
+    void poll(TargetInputHandler &inputHandler, TargetOutputHandler &outputHandler);
+
+    // time (ms) of the event currently passed on by poll()
+    uint32_t eventTick() const { return _eventTick; }
+
+    // number of events dropped because the owner did not poll fast enough
+    uint32_t dropped() const { return _dropped; }
+
+    // TargetInputHandler
+    void writeButton(int index, bool pressed) override;
+    void writeEncoder(EncoderEvent event) override;
+    void writeAdc(int channel, uint16_t value) override;
+    void writeDigitalInput(int pin, bool value) override;
+    void writeMidiInput(MidiEvent event) override;
+
+private:
+    struct Event {
+        enum Kind {
+            Button,
+            Encoder,
+            Adc,
+            DigitalInput,
+            MidiInput,
+            Led,
+            GateOutput,
+            Dac,
+            DigitalOutput,
+            Lcd,
+            MidiOutput,
+        };
+
+        Kind kind;
+        uint32_t tick;
+        int index;
+        int value;
+        MidiEvent midi;
+    };
+
+    class Relay;
+
+    void run();
+    void pushEvent(Event::Kind kind, int index, int value, MidiEvent midi = MidiEvent());
+    void pushFrame(const FrameBuffer &frameBuffer);
+
+    static constexpr int MaxCatchUp = 100;
+
+    Simulator &_simulator;
+    TimeSource _timeSource;
+    std::unique_ptr<Relay> _relay;
+
+    std::thread _thread;
+    std::atomic<bool> _running { false };
+    uint32_t _tick = 0;
+    uint32_t _eventTick = 0;
+    std::atomic<uint32_t> _dropped { 0 };
+
+    SpscQueue<Command, 1024> _commands;
+    SpscQueue<Event, 4096> _events;
+    SpscQueue<FrameBuffer, 4> _frames;
+    FrameBuffer _frame;
+};
+
+} // namespace sim
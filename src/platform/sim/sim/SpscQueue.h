@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <cstddef>
+
+namespace sim {
+
+// Lock-free single producer / single consumer queue. Used to pass data between
+// threads (i.e. rtmidi callbacks, simulator thread) without locking.
+// Slots are reused, so types owning memory (i.e. std::vector) only allocate
+// when growing beyond a previous size.
+template<typename T, size_t Size>
+class SpscQueue {
+public:
+    bool empty() const {
+        return _read.load(std::memory_order_acquire) == _write.load(std::memory_order_acquire);
+    }
+
+    // producer side
+    template<typename Func>
+    bool push(Func func) {
+        size_t write = _write.load(std::memory_order_relaxed);
+        size_t next = (write + 1) % Size;
+        if (next == _read.load(std::memory_order_acquire)) {
+            return false;
+        }
+        func(_buffer[write]);
+        _write.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    T &front() {
+        return _buffer[_read.load(std::memory_order_relaxed)];
+    }
+
+    void pop() {
+        size_t read = _read.load(std::memory_order_relaxed);
+        _read.store((read + 1) % Size, std::memory_order_release);
+    }
+
+private:
+    std::array<T, Size> _buffer;
+    std::atomic<size_t> _read { 0 };
+    std::atomic<size_t> _write { 0 };
+};
+
+} // namespace sim
@@ -11,6 +11,8 @@ struct TracePlayerBase {
     virtual void play(uint32_t tick) = 0;
 };
 
+TracePlayerBase::~TracePlayerBase() {}
+
 template<typename T>
 struct TracePlayer : public TracePlayerBase {
     using Record = typename T::Record;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+
 #include <cstdint>
+#include <cmath>
 
 namespace sim {
 
@@ -9,6 +12,11 @@ static float adcToVoltage(uint16_t adc) {
     return (normalized - 0.5f) * 10.f;
 }
 
+static uint16_t voltageToAdc(float voltage) {
+    float normalized = std::max(0.f, std::min(1.f, voltage * 0.1f + 0.5f));
+    return uint16_t(std::floor(0xffff - 0xffff * normalized));
+}
+
 static float dacToVoltage(uint16_t dac) {
     // In ideal DAC/OpAmp configuration we get:
     // 0     ->  5.17V
@@ -6,8 +6,9 @@ namespace sim {
 // Audio
 // ----------------------------------------------------------------------------
 
-Audio::Audio() {
-    _engine.init(SoLoud::Soloud::CLIP_ROUNDOFF, SoLoud::Soloud::AUTO, 44100, 512);
+Audio::Audio(Mode mode) {
+    auto backend = mode == Mode::Offline ? SoLoud::Soloud::NULLDRIVER : SoLoud::Soloud::AUTO;
+    _engine.init(SoLoud::Soloud::CLIP_ROUNDOFF, backend, SampleRate, 512, Channels);
 }
 
 Audio::~Audio() {
@@ -22,6 +23,10 @@ void Audio::stopAll() {
     _engine.stopAll();
 }
 
+void Audio::mix(float *buffer, int frames) {
+    _engine.mix(buffer, frames);
+}
+
 // ----------------------------------------------------------------------------
 // Sample
 // ----------------------------------------------------------------------------
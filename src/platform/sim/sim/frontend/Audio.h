@@ -11,7 +11,15 @@ class Sample;
 
 class Audio {
 public:
-    Audio();
+    enum class Mode {
+        Realtime,   // output to audio device
+        Offline,    // no audio device, audio is generated by calling mix()
+    };
+
+    static constexpr int SampleRate = 44100;
+    static constexpr int Channels = 2;
+
+    Audio(Mode mode = Mode::Realtime);
     ~Audio();
 
     SoLoud::Soloud &engine() { return _engine; }
@@ -19,6 +27,9 @@ public:
     void play(Sample &sample);
     void stopAll();
 
+    // generate interleaved stereo samples (offline mode only)
+    void mix(float *buffer, int frames);
+
 private:
     SoLoud::Soloud _engine;
 };
@@ -0,0 +1,121 @@
+#include "AudioRenderer.h"
+
+#include "sim/TargetUtils.h"
+
+#include <algorithm>
+
+#include <cmath>
+
+namespace sim {
+
+AudioRenderer::AudioRenderer(Simulator &simulator) :
+    _simulator(simulator),
+    _audio(Audio::Mode::Offline)
+{
+    _instruments.reset(new MixedSetup(_audio));
+
+    _simulator.registerTargetTickObserver(this);
+    _simulator.registerTargetOutputObserver(this);
+}
+
+AudioRenderer::~AudioRenderer() {
+    stop();
+
+    _simulator.unregisterTargetTickObserver(this);
+    _simulator.unregisterTargetOutputObserver(this);
+}
+
+bool AudioRenderer::start(const std::string &filename) {
+    stop();
+
+    _file.open(filename, std::ios::binary);
+    if (!_file.is_open()) {
+        return false;
+    }
+
+    _frames = 0;
+    _blockIndex = 0;
+    writeHeader();
+
+    return true;
+}
+
+void AudioRenderer::stop() {
+    if (!_file.is_open()) {
+        return;
+    }
+
+    // patch header with final size
+    _file.seekp(0);
+    writeHeader();
+    _file.close();
+}
+
+void AudioRenderer::setTick(uint32_t tick) {
+    // outputs of the previous tick have been written, render them
+    if (_file.is_open()) {
+        renderBlock();
+    }
+}
+
+void AudioRenderer::writeGateOutput(int channel, bool value) {
+    _instruments->setGate(channel, value);
+}
+
+void AudioRenderer::writeDac(int channel, uint16_t value) {
+    _instruments->setCv(channel, dacToVoltage(value));
+}
+
+void AudioRenderer::renderBlock() {
+    // distribute samples over 1ms blocks without accumulating rounding errors
+    uint32_t begin = (uint64_t(_blockIndex) * Audio::SampleRate) / 1000;
+    uint32_t end = (uint64_t(_blockIndex + 1) * Audio::SampleRate) / 1000;
+    int frames = end - begin;
+    ++_blockIndex;
+
+    _buffer.resize(frames * Audio::Channels);
+    _audio.mix(_buffer.data(), frames);
+
+    for (auto sample : _buffer) {
+        int16_t value = int16_t(std::round(std::max(-1.f, std::min(1.f, sample)) * 32767.f));
+        uint8_t bytes[2] = { uint8_t(value & 0xff), uint8_t((value >> 8) & 0xff) };
+        _file.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+    }
+
+    _frames += frames;
+}
+
+void AudioRenderer::writeHeader() {
+    auto write16 = [this] (uint16_t value) {
+        uint8_t bytes[2] = { uint8_t(value), uint8_t(value >> 8) };
+        _file.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+    };
+    auto write32 = [this] (uint32_t value) {
+        uint8_t bytes[4] = { uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24) };
+        _file.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+    };
+
+    const uint32_t bytesPerFrame = Audio::Channels * 2;
+    const uint32_t dataSize = _frames * bytesPerFrame;
+
+    // RIFF header
+    _file.write("RIFF", 4);
+    write32(36 + dataSize);
+    _file.write("WAVE", 4);
+
+    // format chunk (16-bit PCM)
+    _file.write("fmt ", 4);
+    write32(16);
+    write16(1);
+    write16(Audio::Channels);
+    write32(Audio::SampleRate);
+    write32(Audio::SampleRate * bytesPerFrame);
+    write16(bytesPerFrame);
+    write16(16);
+
+    // data chunk
+    _file.write("data", 4);
+    write32(dataSize);
+}
+
+} // namespace sim
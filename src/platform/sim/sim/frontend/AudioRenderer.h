@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Audio.h"
+#include "InstrumentSetup.h"
+
+#include "sim/Simulator.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace sim {
+
+// Renders the instrument setup driven by the gate/cv outputs of the simulated
+// target into a WAV file. Audio is generated in lock-step with the simulator,
+// one millisecond block per simulator tick, so rendering runs as fast as the
+// simulator can be stepped and is independent of any audio device.
+class AudioRenderer : public TargetTickHandler, public TargetOutputHandler {
+public:
+    AudioRenderer(Simulator &simulator);
+    ~AudioRenderer();
+
+    bool start(const std::string &filename);
+    void stop();
+
+    bool recording() const { return _file.is_open(); }
+
+    // TargetTickHandler
+    virtual void setTick(uint32_t tick) override;
+
+    // TargetOutputHandler
+    virtual void writeGateOutput(int channel, bool value) override;
+    virtual void writeDac(int channel, uint16_t value) override;
+
+private:
+    void renderBlock();
+    void writeHeader();
+
+    Simulator &_simulator;
+    Audio _audio;
+    std::unique_ptr<InstrumentSetup> _instruments;
+
+    std::ofstream _file;
+    uint32_t _frames = 0;
+    uint32_t _blockIndex = 0;
+    std::vector<float> _buffer;
+};
+
+} // namespace sim
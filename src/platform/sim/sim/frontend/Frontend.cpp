@@ -10,14 +10,18 @@
 #include "instruments/DrumSampler.h"
 #include "instruments/Synth.h"
 
+#include "sim/MidiTraceRecorder.h"
 #include "sim/TargetConfig.h"
 #include "sim/TargetUtils.h"
 
+#include "core/profiler/Profiler.h"
+
 #include "args.hxx"
 #include "tinyformat.h"
 
 #include <memory>
 #include <sstream>
+#include <fstream>
 #include <iomanip>
 
 #ifdef __EMSCRIPTEN__
@@ -37,16 +41,23 @@ static void addWidget(std::vector<T> &list, T widget, int index) {
 }
 
 Frontend::Frontend(Simulator &simulator) :
-    _simulator(simulator)
+    _simulator(simulator),
+    _midi([this] () { return ticks(); }),
+    _hostClock(_audio, [this] () { return ticks(); })
 {
     SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_TIMER);
 
+    // timer is needed before setup() by the host clock
+    _timerFrequency = SDL_GetPerformanceFrequency();
+    _timerStart = SDL_GetPerformanceCounter();
+
 #ifdef __EMSCRIPTEN__
     g_instance = this;
 #endif
 }
 
 Frontend::~Frontend() {
+    _simulatorThread.reset();
     SDL_Quit();
 }
 
@@ -54,6 +65,13 @@ int Frontend::main(int argc, char *argv[]) {
     args::ArgumentParser parser("PER|FORMER Simulator", "");
     args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
     args::Flag showMidiPorts(parser, "midi", "Show available MIDI ports", { 'm', "midi" });
+#if CONFIG_ENABLE_PROFILER
+    args::ValueFlag<std::string> profilerTrace(parser, "file", "Write profiler timeline in chrome trace format on exit", { "profiler-trace" });
+#endif
+    args::ValueFlag<std::string> clock(parser, "source", "Clock driving the simulator (system, audio, midi)", { "clock" });
+    args::ValueFlag<double> clockBpm(parser, "bpm", "Tempo of the external MIDI clock when using --clock midi", { "clock-bpm" });
+    args::Flag threaded(parser, "threaded", "Run the simulator on a separate thread", { "threaded" });
+    args::ValueFlag<std::string> captureMidi(parser, "file", "Capture MIDI input into a trace file (replay with sequencer_headless --replay)", { "capture-midi" });
 
     try {
         parser.ParseCLI(argc, argv);
@@ -71,10 +89,61 @@ int Frontend::main(int argc, char *argv[]) {
         return 0;
     }
 
+    if (clock) {
+        const auto &source = args::get(clock);
+        if (source == "audio") {
+            _hostClock.setMode(HostClock::Mode::Audio);
+        } else if (source == "midi") {
+            _hostClock.setMode(HostClock::Mode::MidiClock);
+        } else if (source != "system") {
+            std::cerr << "Invalid clock source '" << source << "'" << std::endl;
+            return 1;
+        }
+    }
+    if (clockBpm) {
+        _hostClock.setMidiClockBpm(args::get(clockBpm));
+    }
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+    _threaded = true;
+#else
+    _threaded = threaded;
+#endif
+    if (_threaded && _hostClock.mode() != HostClock::Mode::System) {
+        std::cerr << "Clock source '" << args::get(clock) << "' is not supported when running threaded" << std::endl;
+        return 1;
+    }
 
+    std::unique_ptr<TargetTrace> midiTrace;
+    std::unique_ptr<MidiTraceRecorder> midiTraceRecorder;
+    if (captureMidi) {
+        midiTrace.reset(new TargetTrace());
+        midiTraceRecorder.reset(new MidiTraceRecorder(_simulator, *midiTrace));
+    }
 
     run();
 
+    if (midiTraceRecorder) {
+        // make sure the simulator thread is no longer recording
+        if (_simulatorThread) {
+            _simulatorThread->stop();
+        }
+        midiTrace->saveToFile(args::get(captureMidi));
+        std::string hostTimesFilename = args::get(captureMidi) + ".time";
+        if (!midiTraceRecorder->saveHostTimes(hostTimesFilename)) {
+            std::cerr << "Failed to write host times to " << hostTimesFilename << std::endl;
+        }
+        std::cout << "Captured " << midiTrace->midiInput.items().size() << " MIDI events" << std::endl;
+        midiTraceRecorder.reset();
+    }
+
+#if CONFIG_ENABLE_PROFILER
+    if (profilerTrace) {
+        std::ofstream ofs(args::get(profilerTrace));
+        Profiler::writeTrace([&ofs] (const char *str) { ofs << str; });
+    }
+#endif
+
     return 0;
 }
 
@@ -114,13 +183,32 @@ void Frontend::step() {
 }
 
 void Frontend::update() {
-    uint32_t currentTicks = std::floor(ticks());
-    for (uint32_t tick = _lastUpdateTicks; tick < currentTicks; ++tick) {
+    _midi.update();
+
+    double systemTicks = ticks();
+
+    if (_simulatorThread) {
+        // simulator advances on its own thread, exchange inputs and events
+        _midi.dispatch(systemTicks);
+        _simulatorThread->poll(*this, *this);
+        _midi.flush(systemTicks);
+        _window->update();
+        return;
+    }
+
+    // simulator time follows the host clock, MIDI input is timestamped in system time
+    double hostTicks = _hostClock.ticks();
+    uint32_t currentTicks = std::floor(hostTicks);
+    uint32_t steps = currentTicks > _lastUpdateTicks ? currentTicks - _lastUpdateTicks : 0;
+    for (uint32_t step = 0; step < steps; ++step) {
+        // deliver MIDI messages at the simulator step they were received in
+        _midi.dispatch(_lastUpdateSystemTicks + (systemTicks - _lastUpdateSystemTicks) * (step + 1) / steps);
         _simulator.wait(1);
     }
-    _lastUpdateTicks = currentTicks;
+    _lastUpdateTicks = std::max(_lastUpdateTicks, currentTicks);
+    _lastUpdateSystemTicks = systemTicks;
 
-    _midi.update();
+    _midi.flush(hostTicks);
     _window->update();
 }
 
@@ -143,9 +231,6 @@ double Frontend::ticks() const {
 }
 
 void Frontend::setup() {
-    _timerFrequency = SDL_GetPerformanceFrequency();
-    _timerStart = SDL_GetPerformanceCounter();
-
 #ifdef __EMSCRIPTEN__
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
@@ -161,12 +246,23 @@ void Frontend::setup() {
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 8);
 
+    if (_threaded) {
+        _simulatorThread.reset(new SimulatorThread(_simulator, [this] () { return ticks(); }));
+    }
+
     setupWindow();
     setupMidi();
     setupInstruments();
 
-    _simulator.registerTargetInputObserver(this);
-    _simulator.registerTargetOutputObserver(this);
+    if (_simulatorThread) {
+        // drive instruments directly from the simulator thread to avoid gate/cv jitter
+        _instrumentOutput.reset(new InstrumentOutputHandler(*_instruments));
+        _simulator.registerTargetOutputObserver(_instrumentOutput.get());
+        _simulatorThread->start();
+    } else {
+        _simulator.registerTargetInputObserver(this);
+        _simulator.registerTargetOutputObserver(this);
+    }
 }
 
 void Frontend::setupWindow() {
@@ -249,7 +345,7 @@ void Frontend::setupFrontpanel() {
             );
             if (info.signal == Frontpanel::Signal::Button) {
                 button->setCallback([this, info] (bool pressed) {
-                    _simulator.writeButton(info.index, pressed);
+                    input().writeButton(info.index, pressed);
                 });
                 addWidget(_buttons, button, info.index);
             }
@@ -258,17 +354,17 @@ void Frontend::setupFrontpanel() {
         case Frontpanel::Widget::Encoder: {
             _encoder = _window->createWidget<Encoder>(origin - size / 2, size, SDLK_SPACE);
             _encoder->setButtonCallback([this] (bool pressed) {
-                _simulator.writeEncoder(pressed ? EncoderEvent::Down : EncoderEvent::Up);
+                input().writeEncoder(pressed ? EncoderEvent::Down : EncoderEvent::Up);
             });
 
             _encoder->setValueCallback([this] (int value) {
                 if (value > 0) {
                     for (int i = 0; i < value; ++i) {
-                        _simulator.writeEncoder(EncoderEvent::Right);
+                        input().writeEncoder(EncoderEvent::Right);
                     }
                 } else if (value < 0) {
                     for (int i = 0; i > value; --i) {
-                        _simulator.writeEncoder(EncoderEvent::Left);
+                        input().writeEncoder(EncoderEvent::Left);
                     }
                 }
             });
@@ -294,9 +390,9 @@ void Frontend::setupControls() {
     for (int i = 0; i < TargetConfig::AdcChannels; ++i) {
         auto rotary = _window->createWidget<Rotary>(Vector2f(x, y + 10), Vector2f(40, 40));
         rotary->setValueCallback([this, i] (float value) {
-            _simulator.setAdc(i, value * 10.f - 5.f);
+            input().writeAdc(i, voltageToAdc(value * 10.f - 5.f));
         });
-        _simulator.setAdc(i, 0.f);
+        input().writeAdc(i, voltageToAdc(0.f));
         _window->createWidget<Label>(Vector2f(x, y + 60), Vector2f(40, 10), tfm::format("CV%d IN", i + 1));
         x += 50;
     }
@@ -312,6 +408,7 @@ void Frontend::setupControls() {
         _window->createWidget<Label>(Vector2f(x, y + 60), Vector2f(40, 10), "CLK IN");
         x += 50;
 
+        // clock source is updated by the simulator (on the simulator thread if running threaded)
         _clockSource.reset(new ClockSource(_simulator, [this] () {
             _simulator.writeDigitalInput(0, true);
             _simulator.writeDigitalInput(0, false);
@@ -319,7 +416,7 @@ void Frontend::setupControls() {
 
         button->setCallback([this] (bool pressed) {
             if (pressed) {
-                _clockSource->toggle();
+                runOnSimulator([this] (Simulator &simulator) { _clockSource->toggle(); });
             }
         });
     }
@@ -336,7 +433,7 @@ void Frontend::setupControls() {
         x += 50;
 
         button->setCallback([this] (bool pressed) {
-            _simulator.writeDigitalInput(1, pressed);
+            input().writeDigitalInput(1, pressed);
         });
     }
 
@@ -353,7 +450,7 @@ void Frontend::setupControls() {
 
         button->setCallback([&] (bool pressed) {
             if (pressed) {
-                _simulator.screenshot("screenshot.png");
+                runOnSimulator([] (Simulator &simulator) { simulator.screenshot("screenshot.png"); });
             }
         });
 
@@ -375,33 +472,62 @@ void Frontend::setupMidi() {
         midiPortConfig.portIn,
         midiPortConfig.portOut,
         [this] (const std::vector<uint8_t> &message) {
-            if (message.size() >= 1 && message.size() <= 3) {
-                _simulator.writeMidiInput(MidiEvent::makeMessage(0, MidiMessage(message.data(), message.size())));
-            }
+            receiveMidi(0, message);
         }
     );
 
+    _midiPort->setClockHandler([this] (double time) {
+        _hostClock.midiClock(time);
+    });
+
     _midi.registerPort(_midiPort);
 
     _usbMidiPort = std::make_shared<sim::Midi::Port>(
         usbMidiPortConfig.portIn,
         usbMidiPortConfig.portOut,
         [this] (const std::vector<uint8_t> &message) {
-            if (message.size() >= 1 && message.size() <= 3) {
-                _simulator.writeMidiInput(MidiEvent::makeMessage(1, MidiMessage(message.data(), message.size())));
-            }
+            receiveMidi(1, message);
         },
         [this] () {
-            _simulator.writeMidiInput(MidiEvent::makeConnect(1, usbMidiPortConfig.vendorId, usbMidiPortConfig.productId));
+            input().writeMidiInput(MidiEvent::makeConnect(1, usbMidiPortConfig.vendorId, usbMidiPortConfig.productId));
         },
         [this] () {
-            _simulator.writeMidiInput(MidiEvent::makeDisconnect(1));
+            input().writeMidiInput(MidiEvent::makeDisconnect(1));
         }
     );
 
     _midi.registerPort(_usbMidiPort);
 }
 
+void Frontend::receiveMidi(int port, const std::vector<uint8_t> &message) {
+    if (!message.empty() && message[0] == MidiMessage::SystemExclusive) {
+        for (size_t i = 0; i < message.size(); i += MidiEvent::SysExPacketSize) {
+            input().writeMidiInput(MidiEvent::makeSysEx(port, &message[i], message.size() - i));
+        }
+    } else if (message.size() >= 1 && message.size() <= 3) {
+        input().writeMidiInput(MidiEvent::makeMessage(port, MidiMessage(message.data(), message.size())));
+    }
+}
+
+TargetInputHandler &Frontend::input() {
+    if (_simulatorThread) {
+        return *_simulatorThread;
+    }
+    return _simulator;
+}
+
+void Frontend::runOnSimulator(SimulatorThread::Command command) {
+    if (_simulatorThread) {
+        _simulatorThread->post(command);
+    } else {
+        command(_simulator);
+    }
+}
+
+double Frontend::simulatorTicks() const {
+    return _simulatorThread ? _simulatorThread->eventTick() : _simulator.ticks();
+}
+
 void Frontend::setupInstruments() {
     // _instruments.reset(new SamplerSetup(_audio));
     _instruments.reset(new MixedSetup(_audio));
@@ -443,7 +569,9 @@ void Frontend::writeLed(int index, bool red, bool green) {
 }
 
 void Frontend::writeGateOutput(int channel, bool value) {
-    _instruments->setGate(channel, value);
+    if (!_simulatorThread) {
+        _instruments->setGate(channel, value);
+    }
     if (channel >= 0 && channel < int(_gateOutputJacks.size())) {
         _gateOutputJacks[channel]->setState(value);
     }
@@ -451,7 +579,9 @@ void Frontend::writeGateOutput(int channel, bool value) {
 
 void Frontend::writeDac(int channel, uint16_t value) {
     float voltage = dacToVoltage(value);
-    _instruments->setCv(channel, voltage);
+    if (!_simulatorThread) {
+        _instruments->setCv(channel, voltage);
+    }
     if (channel >= 0 && channel < int(_cvOutputJacks.size())) {
         _cvOutputJacks[channel]->setValue(voltage, -5.f, 5.f);
     }
@@ -469,15 +599,26 @@ void Frontend::writeLcd(const FrameBuffer &frameBuffer) {
 
 void Frontend::writeMidiOutput(MidiEvent event) {
     if (event.kind == MidiEvent::Message) {
+        // schedule relative to the simulator step the message was sent in
         const auto &message = event.message;
+        double time = simulatorTicks() + Midi::OutputLatency;
         switch (event.port) {
         case 0:
-            _midiPort->send(message.raw(), message.length());
+            _midiPort->send(message.raw(), message.length(), time);
             break;
         case 1:
-            _usbMidiPort->send(message.raw(), message.length());
+            _usbMidiPort->send(message.raw(), message.length(), time);
             break;
         }
+    } else if (event.kind == MidiEvent::SysEx && event.port >= 0 && event.port < int(_sysExOutput.size())) {
+        auto &data = _sysExOutput[event.port];
+        data.insert(data.end(), event.sysEx.data, event.sysEx.data + event.sysEx.length);
+        if (data.back() == MidiMessage::EndOfExclusive) {
+            double time = simulatorTicks() + Midi::OutputLatency;
+            auto &midiPort = event.port == 0 ? _midiPort : _usbMidiPort;
+            midiPort->send(data.data(), data.size(), time);
+            data.clear();
+        }
     }
 }
 
@@ -6,6 +6,7 @@
 #include "InstrumentSetup.h"
 #include "Midi.h"
 #include "ClockSource.h"
+#include "HostClock.h"
 
 #include "widgets/Button.h"
 #include "widgets/Display.h"
@@ -16,7 +17,9 @@
 #include "widgets/Jack.h"
 
 #include "sim/Simulator.h"
+#include "sim/SimulatorThread.h"
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -50,8 +53,14 @@ private:
     void setupControls();
 
     void setupMidi();
+    void receiveMidi(int port, const std::vector<uint8_t> &message);
     void setupInstruments();
 
+    // inputs go to the simulator directly or through the simulator thread
+    TargetInputHandler &input();
+    void runOnSimulator(SimulatorThread::Command command);
+    double simulatorTicks() const;
+
     // TargetInputHandler
     void writeButton(int index, bool pressed) override;
     void writeEncoder(EncoderEvent event) override;
@@ -68,18 +77,26 @@ private:
     void writeMidiOutput(MidiEvent event) override;
 
     Simulator &_simulator;
+    bool _threaded = false;
+    std::unique_ptr<SimulatorThread> _simulatorThread;
     Audio _audio;
     std::unique_ptr<InstrumentSetup> _instruments;
+    std::unique_ptr<InstrumentOutputHandler> _instrumentOutput;
 
     double _timerFrequency;
     double _timerStart;
 
     uint32_t _lastUpdateTicks = 0;
+    double _lastUpdateSystemTicks = 0.0;
     double _lastRenderTicks = 0.0;
 
     Midi _midi;
     std::shared_ptr<Midi::Port> _midiPort;
     std::shared_ptr<Midi::Port> _usbMidiPort;
+    // SysEx output is collected until the message is complete
+    std::array<std::vector<uint8_t>, 2> _sysExOutput;
+
+    HostClock _hostClock;
 
     std::unique_ptr<ClockSource> _clockSource;
 
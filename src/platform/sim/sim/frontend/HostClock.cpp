@@ -0,0 +1,169 @@
+#include "HostClock.h"
+
+#include <algorithm>
+
+namespace sim {
+
+// fall back to free running when no reference event was received for this long (ms)
+static constexpr double LockTimeout = 250.0;
+
+// loop bandwidths relative to the event rate
+static constexpr double AudioBandwidth = 0.01;
+static constexpr double MidiClockBandwidth = 0.05;
+
+static constexpr int MidiClockPpqn = 24;
+
+// ----------------------------------------------------------------------------
+// AudioClock
+// ----------------------------------------------------------------------------
+
+// Silent audio source reporting the number of frames consumed by the audio device.
+class HostClock::AudioClock : public SoLoud::AudioSource {
+public:
+    class Instance : public SoLoud::AudioSourceInstance {
+    public:
+        Instance(HostClock &clock) :
+            _clock(clock)
+        {}
+
+        virtual void getAudio(float *aBuffer, unsigned int aSamples) override {
+            std::fill(aBuffer, aBuffer + aSamples, 0.f);
+            _frames += aSamples;
+            _clock.audioClock(_frames, aSamples);
+        }
+
+        virtual bool hasEnded() override {
+            return false;
+        }
+
+    private:
+        HostClock &_clock;
+        uint64_t _frames = 0;
+    };
+
+    AudioClock(HostClock &clock) :
+        _clock(clock)
+    {
+        setSingleInstance(true);
+    }
+
+    virtual SoLoud::AudioSourceInstance *createInstance() override {
+        return new Instance(_clock);
+    }
+
+private:
+    HostClock &_clock;
+};
+
+// ----------------------------------------------------------------------------
+// HostClock
+// ----------------------------------------------------------------------------
+
+HostClock::HostClock(Audio &audio, TimeSource systemTime) :
+    _audio(audio),
+    _systemTime(systemTime),
+    _audioClock(new AudioClock(*this))
+{
+}
+
+HostClock::~HostClock() {
+    setMode(Mode::System);
+}
+
+void HostClock::setMode(Mode mode) {
+    if (mode == _mode) {
+        return;
+    }
+
+    if (_mode == Mode::Audio) {
+        _audio.engine().stop(_audioHandle);
+        _audioHandle = -1;
+    }
+
+    _mode = mode;
+    _locked = false;
+
+    if (_mode == Mode::Audio) {
+        _audioHandle = _audio.engine().play(*_audioClock);
+    }
+}
+
+double HostClock::ticks() {
+    double systemTime = _systemTime();
+
+    // process reference events of the active mode, discard others
+    while (!_audioEvents.empty()) {
+        if (_mode == Mode::Audio) {
+            lock(_audioEvents.front());
+        }
+        _audioEvents.pop();
+    }
+    while (!_midiEvents.empty()) {
+        if (_mode == Mode::MidiClock) {
+            auto event = _midiEvents.front();
+            event.interval = 60000.0 / (_midiClockBpm * MidiClockPpqn);
+            event.reference = _locked ? _reference + event.interval : 0.0;
+            lock(event);
+        }
+        _midiEvents.pop();
+    }
+
+    if (_locked && systemTime - _dll.t0() > LockTimeout) {
+        _locked = false;
+    }
+
+    double time;
+    if (_locked) {
+        // interpolate reference time between last and predicted next event
+        double period = _dll.t1() - _dll.t0();
+        double fraction = period > 0.0 ? (systemTime - _dll.t0()) / period : 1.0;
+        fraction = std::max(0.0, std::min(1.0, fraction));
+        time = _offset + _reference + _interval * fraction;
+    } else {
+        time = freeRun(systemTime);
+    }
+
+    time = std::max(time, _lastTime);
+    _lastTime = time;
+    _lastSystemTime = systemTime;
+
+    return time;
+}
+
+void HostClock::midiClock(double time) {
+    _midiEvents.push([time] (Event &event) {
+        event.time = time;
+        event.reference = 0.0;
+        event.interval = 0.0;
+    });
+}
+
+void HostClock::audioClock(uint64_t frames, uint32_t length) {
+    double time = _systemTime();
+    _audioEvents.push([time, frames, length] (Event &event) {
+        event.time = time;
+        event.reference = frames * 1000.0 / Audio::SampleRate;
+        event.interval = length * 1000.0 / Audio::SampleRate;
+    });
+}
+
+void HostClock::lock(const Event &event) {
+    if (!_locked) {
+        // start locking, keep simulator time continuous
+        _dll.setBandwidth(_mode == Mode::Audio ? AudioBandwidth : MidiClockBandwidth);
+        _dll.reset(event.time, event.interval);
+        _offset = freeRun(event.time) - event.reference;
+        _locked = true;
+    } else {
+        _dll.update(event.time);
+    }
+
+    _reference = event.reference;
+    _interval = event.interval;
+}
+
+double HostClock::freeRun(double systemTime) {
+    return _lastTime + std::max(0.0, systemTime - _lastSystemTime);
+}
+
+} // namespace sim
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Audio.h"
+
+#include "sim/SpscQueue.h"
+
+#include "soloud.h"
+
+#include <functional>
+#include <memory>
+
+#include <cmath>
+#include <cstdint>
+
+namespace sim {
+
+// Delay-locked loop filtering jittery timestamps of a periodic event
+// (F. Adriaensen, "Using a DLL to filter time"). All times in ms.
+class DelayLockedLoop {
+public:
+    // bandwidth relative to the event rate
+    void setBandwidth(double bandwidth) {
+        double omega = 2.0 * M_PI * bandwidth;
+        _b = std::sqrt(2.0) * omega;
+        _c = omega * omega;
+    }
+
+    void reset(double time, double period) {
+        _t0 = time;
+        _t1 = time + period;
+        _period = period;
+    }
+
+    void update(double time) {
+        double error = time - _t1;
+        _t0 = _t1;
+        _t1 += _b * error + _period;
+        _period += _c * error;
+    }
+
+    // filtered time of the last event
+    double t0() const { return _t0; }
+    // predicted time of the next event
+    double t1() const { return _t1; }
+    double period() const { return _period; }
+
+private:
+    double _b = 0.0;
+    double _c = 0.0;
+    double _t0 = 0.0;
+    double _t1 = 0.0;
+    double _period = 0.0;
+};
+
+// Provides the time base used to advance the simulator. By default the
+// simulator follows the system clock. Alternatively it can be locked to the
+// sample clock of the audio device or to an external MIDI clock, in which
+// case simulator time follows the reference clock and drift between the
+// reference and the system clock is corrected.
+class HostClock {
+public:
+    typedef std::function<double()> TimeSource;
+
+    enum class Mode {
+        System,
+        Audio,
+        MidiClock,
+    };
+
+    HostClock(Audio &audio, TimeSource systemTime);
+    ~HostClock();
+
+    Mode mode() const { return _mode; }
+    void setMode(Mode mode);
+
+    // tempo of the external MIDI clock, needed to convert clock pulses to time
+    double midiClockBpm() const { return _midiClockBpm; }
+    void setMidiClockBpm(double bpm) { _midiClockBpm = bpm; }
+
+    // returns current time (ms), called from main thread
+    double ticks();
+
+    // called from rtmidi thread with the timestamp (ms, system time) of a MIDI clock pulse
+    void midiClock(double time);
+
+private:
+    struct Event {
+        double time;        // system time
+        double reference;   // reference time
+        double interval;    // reference time since previous event
+    };
+
+    class AudioClock;
+    friend class AudioClock;
+
+    // called from audio thread
+    void audioClock(uint64_t frames, uint32_t length);
+
+    void lock(const Event &event);
+    double freeRun(double systemTime);
+
+    Audio &_audio;
+    TimeSource _systemTime;
+    Mode _mode = Mode::System;
+    double _midiClockBpm = 120.0;
+
+    std::unique_ptr<AudioClock> _audioClock;
+    int _audioHandle = -1;
+
+    SpscQueue<Event, 256> _audioEvents;
+    SpscQueue<Event, 256> _midiEvents;
+
+    DelayLockedLoop _dll;
+    bool _locked = false;
+    double _reference = 0.0;    // reference time at last event
+    double _interval = 0.0;     // reference time between events
+    double _offset = 0.0;       // offset from reference to simulator time
+
+    double _lastTime = 0.0;
+    double _lastSystemTime = 0.0;
+};
+
+} // namespace sim
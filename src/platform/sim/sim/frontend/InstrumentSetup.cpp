@@ -21,4 +21,10 @@ MixedSetup::MixedSetup(Audio &audio) {
     _instruments.emplace_back(std::make_shared<Synth>(audio));
 }
 
+SynthSetup::SynthSetup(Audio &audio) {
+    for (int i = 0; i < 8; ++i) {
+        _instruments.emplace_back(std::make_shared<Synth>(audio));
+    }
+}
+
 } // namespace sim
@@ -3,6 +3,9 @@
 #include "instruments/DrumSampler.h"
 #include "instruments/Synth.h"
 
+#include "sim/Target.h"
+#include "sim/TargetUtils.h"
+
 #include <memory>
 
 namespace sim {
@@ -33,4 +36,28 @@ public:
     MixedSetup(Audio &audio);
 };
 
+class SynthSetup : public InstrumentSetup {
+public:
+    SynthSetup(Audio &audio);
+};
+
+// Drives an instrument setup from the gate/cv outputs of the target.
+class InstrumentOutputHandler : public TargetOutputHandler {
+public:
+    InstrumentOutputHandler(InstrumentSetup &instruments) :
+        _instruments(instruments)
+    {}
+
+    void writeGateOutput(int channel, bool value) override {
+        _instruments.setGate(channel, value);
+    }
+
+    void writeDac(int channel, uint16_t value) override {
+        _instruments.setCv(channel, dacToVoltage(value));
+    }
+
+private:
+    InstrumentSetup &_instruments;
+};
+
 } // namespace sim
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Common.h"
+
+#include <array>
+#include <memory>
+
+#include <cstdint>
+#include <cstring>
+
+namespace sim {
+
+// Converts LCD frames (4-bit intensity per pixel) to an RGBA image using a
+// palette. Only rows that changed since the previous frame are converted and
+// the range of changed rows is tracked, so that uploading the image can be
+// limited to the rows that actually changed.
+class LcdImage {
+public:
+    LcdImage(int width, int height, const Color &color) :
+        _width(width),
+        _height(height),
+        _frame(new uint8_t[width * height]),
+        _image(new uint32_t[width * height])
+    {
+        std::memset(_frame.get(), 0, width * height);
+        setColor(color);
+    }
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    const Color &color() const { return _color; }
+    void setColor(const Color &color) {
+        _color = color;
+        for (int i = 0; i < int(_palette.size()); ++i) {
+            float s = i * (1.f / 15.f);
+            _palette[i] = Color(s * _color.r(), s * _color.g(), s * _color.b(), 1.f).rgba();
+        }
+        // reconvert everything
+        convertRows(0, _height);
+    }
+
+    void update(const uint8_t *frame) {
+        for (int y = 0; y < _height; ++y) {
+            const uint8_t *src = frame + y * _width;
+            uint8_t *dst = _frame.get() + y * _width;
+            if (std::memcmp(src, dst, _width) != 0) {
+                std::memcpy(dst, src, _width);
+                convertRows(y, y + 1);
+            }
+        }
+    }
+
+    const uint32_t *data() const { return _image.get(); }
+
+    // range of rows changed since last call to clearDirty()
+    bool dirty() const { return _dirtyBegin < _dirtyEnd; }
+    int dirtyBegin() const { return _dirtyBegin; }
+    int dirtyEnd() const { return _dirtyEnd; }
+    void clearDirty() {
+        _dirtyBegin = _height;
+        _dirtyEnd = 0;
+    }
+
+    // total number of converted rows
+    uint32_t convertedRows() const { return _convertedRows; }
+
+private:
+    void convertRows(int begin, int end) {
+        for (int i = begin * _width; i < end * _width; ++i) {
+            _image[i] = _palette[std::min(uint8_t(15), _frame[i])];
+        }
+        _dirtyBegin = std::min(_dirtyBegin, begin);
+        _dirtyEnd = std::max(_dirtyEnd, end);
+        _convertedRows += end - begin;
+    }
+
+    int _width;
+    int _height;
+    Color _color;
+    std::array<uint32_t, 16> _palette;
+    std::unique_ptr<uint8_t[]> _frame;
+    std::unique_ptr<uint32_t[]> _image;
+    int _dirtyBegin = 0;
+    int _dirtyEnd = 0;
+    uint32_t _convertedRows = 0;
+};
+
+} // namespace sim
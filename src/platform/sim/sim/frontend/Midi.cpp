@@ -14,9 +14,12 @@ static int findPort(T &midi, const std::string &port) {
     return -1;
 }
 
+// received messages are re-anchored to arrival time when accumulated rtmidi timestamps drift off further than this (ms)
+static constexpr double MaxRecvDrift = 20.0;
+
 static void recvCallback(double timeStamp, std::vector<uint8_t> *message, void *userData) {
     auto &port = *static_cast<Midi::Port *>(userData);
-    port.receive(*message);
+    port.receive(timeStamp, *message);
 }
 
 static void errorCallback(RtMidiError::Type type, const std::string &errorText, void *userData) {
@@ -24,20 +27,9 @@ static void errorCallback(RtMidiError::Type type, const std::string &errorText,
     port.notifyError();
 }
 
-bool Midi::Port::send(uint8_t data) {
+bool Midi::Port::send(const uint8_t *data, size_t length, double time) {
     if (_output.isPortOpen()) {
-        std::vector<uint8_t> message = { data };
-        _output.sendMessage(&message);
-        return true;
-    }
-
-    return false;
-}
-
-bool Midi::Port::send(const uint8_t *data, size_t length) {
-    if (_output.isPortOpen()) {
-        std::vector<uint8_t> message(data, data + length);
-        _output.sendMessage(&message);
+        _sendQueue.emplace_back(TimedMessage{ time, std::vector<uint8_t>(data, data + length) });
         return true;
     }
 
@@ -51,12 +43,22 @@ void Midi::Port::update() {
         if (_error || findPort(_input, _portIn) == -1 || findPort(_output, _portOut) == -1) {
             close();
         }
+    }
+}
+
+void Midi::Port::dispatch(double time) {
+    while (!_recvQueue.empty() && _recvQueue.front().time < time) {
+        _recvHandler(_recvQueue.front().data);
+        _recvQueue.pop();
+    }
+}
 
-        std::lock_guard<std::mutex> lock(_recvQueueMutex);
-        while (!_recvQueue.empty()) {
-            _recvHandler(_recvQueue.front());
-            _recvQueue.pop_front();
+void Midi::Port::flush(double time) {
+    while (!_sendQueue.empty() && _sendQueue.front().time <= time) {
+        if (_output.isPortOpen()) {
+            _output.sendMessage(&_sendQueue.front().data);
         }
+        _sendQueue.pop_front();
     }
 }
 
@@ -64,9 +66,26 @@ void Midi::Port::notifyError() {
     _error = true;
 }
 
-void Midi::Port::receive(const std::vector<uint8_t> &message) {
-    std::lock_guard<std::mutex> lock(_recvQueueMutex);
-    _recvQueue.emplace_back(message);
+void Midi::Port::receive(double deltaTime, const std::vector<uint8_t> &message) {
+    // rtmidi timestamps are deltas to the previous message, accumulate them to preserve
+    // the timing of messages delivered in bursts but keep them close to the arrival time
+    double now = _timeSource();
+    double time = _lastRecvTime + deltaTime * 1000.0;
+    if (_firstRecv || time > now || time < now - MaxRecvDrift) {
+        time = now;
+    }
+    _firstRecv = false;
+    _lastRecvTime = time;
+
+    if (_clockHandler && message.size() == 1 && message[0] == 0xf8) {
+        _clockHandler(time);
+    }
+
+    // drop message if queue is full
+    _recvQueue.push([&] (TimedMessage &entry) {
+        entry.time = time;
+        entry.data = message;
+    });
 }
 
 void Midi::Port::open() {
@@ -78,6 +97,7 @@ void Midi::Port::open() {
     try {
         int index = findPort(_input, _portIn);
         if (index >= 0) {
+            _firstRecv = true;
             _input.openPort(index);
             _input.ignoreTypes(false, false, false);
             _input.setCallback(recvCallback, this);
@@ -131,6 +151,7 @@ void Midi::Port::close() {
 
     _input.closePort();
     _output.closePort();
+    _sendQueue.clear();
 
     if (_disconnectHandler) {
         _disconnectHandler();
@@ -140,10 +161,13 @@ void Midi::Port::close() {
     _firstOpenAttempt = true;
 }
 
-Midi::Midi() {
+Midi::Midi(TimeSource timeSource) :
+    _timeSource(timeSource)
+{
 }
 
 void Midi::registerPort(std::shared_ptr<Port> port) {
+    port->_timeSource = _timeSource;
     _ports.emplace_back(port);
 }
 
@@ -178,5 +202,17 @@ void Midi::update() {
     }
 }
 
+void Midi::dispatch(double time) {
+    for (const auto &port : _ports) {
+        port->dispatch(time);
+    }
+}
+
+void Midi::flush(double time) {
+    for (const auto &port : _ports) {
+        port->flush(time);
+    }
+}
+
 
 } // namespace sim
@@ -1,13 +1,15 @@
 #pragma once
 
+#include "sim/SpscQueue.h"
+
 #include "RtMidi.h"
 
 #include <unordered_map>
+#include <atomic>
 #include <string>
 #include <memory>
 #include <functional>
 #include <deque>
-#include <mutex>
 
 #include <cstdint>
 
@@ -20,6 +22,7 @@ public:
         typedef std::function<void(const std::vector<uint8_t> &message)> RecvHandler;
         typedef std::function<void()> ConnectHandler;
         typedef std::function<void()> DisconnectHandler;
+        typedef std::function<void(double time)> ClockHandler;
 
         Port(
             const std::string &portIn,
@@ -37,15 +40,30 @@ public:
 
         bool isOpen() const { return _open; }
 
-        bool send(uint8_t data);
-        bool send(const uint8_t *data, size_t length);
+        // handler called from rtmidi thread with the timestamp of each received MIDI clock message
+        void setClockHandler(ClockHandler clockHandler) { _clockHandler = clockHandler; }
+
+        // schedule message to be sent at the given time (ms)
+        bool send(const uint8_t *data, size_t length, double time);
 
         void update();
 
+        // pass received messages with a timestamp before the given time (ms) to the receive handler
+        void dispatch(double time);
+
+        // send scheduled messages that are due at the given time (ms)
+        void flush(double time);
+
+        // called from rtmidi thread
         void notifyError();
-        void receive(const std::vector<uint8_t> &message);
+        void receive(double deltaTime, const std::vector<uint8_t> &message);
 
     private:
+        struct TimedMessage {
+            double time;
+            std::vector<uint8_t> data;
+        };
+
         void open();
         void close();
 
@@ -54,27 +72,43 @@ public:
         RecvHandler _recvHandler;
         ConnectHandler _connectHandler;
         DisconnectHandler _disconnectHandler;
+        ClockHandler _clockHandler;
 
         bool _open = false;
         RtMidiIn _input;
         RtMidiOut _output;
 
         bool _firstOpenAttempt = true;
-        bool _error = false;
+        std::atomic<bool> _error { false };
 
-        std::deque<std::vector<uint8_t>> _recvQueue;
-        std::mutex _recvQueueMutex;
+        std::function<double()> _timeSource;
+        bool _firstRecv = true;
+        double _lastRecvTime = 0.0;
+
+        SpscQueue<TimedMessage, 1024> _recvQueue;
+        std::deque<TimedMessage> _sendQueue;
+
+        friend class Midi;
     };
 
-    Midi();
+    typedef std::function<double()> TimeSource;
+
+    // Outgoing messages are delayed by this amount (ms) to compensate for the
+    // simulator being stepped in bursts, keeping their relative timing intact.
+    static constexpr double OutputLatency = 5.0;
+
+    Midi(TimeSource timeSource);
 
     void registerPort(std::shared_ptr<Port> port);
 
     void update();
+    void dispatch(double time);
+    void flush(double time);
 
     void dumpPorts();
 
 private:
+    TimeSource _timeSource;
     std::vector<std::shared_ptr<Port>> _ports;
 };
 
@@ -1,14 +1,79 @@
 #include "Synth.h"
 
+#include <algorithm>
+
 #include <cstdint>
 #include <cmath>
 
 namespace sim {
 
-static float flushDenormal(float value) {
+static inline float flushDenormal(float value) {
     return ((((*(uint32_t *) &(value))) & 0x7f800000) == 0) ? 0.f : value;
 }
 
+// Voices are processed in blocks of up to this many samples. Parameters are
+// latched at the start of each block and smoothed across it.
+static constexpr int BlockSize = 64;
+
+// Linear ramp from current to target value over one block.
+class SmoothedValue {
+public:
+    void reset(float value) {
+        _value = value;
+        _target = value;
+    }
+
+    void setTarget(float target) { _target = target; }
+
+    // returns increment per sample for the next block of given length and advances to the target
+    inline float beginBlock(int length, float &start) {
+        start = _value;
+        float increment = (_target - _value) / length;
+        _value = _target;
+        return increment;
+    }
+
+private:
+    float _value = 0.f;
+    float _target = 0.f;
+};
+
+class SineTable {
+public:
+    static constexpr int Size = 1024;
+
+    SineTable() {
+        for (int i = 0; i <= Size; ++i) {
+            _table[i] = std::sin(TWO_PI * i / Size);
+        }
+    }
+
+    // phase in [0..1)
+    inline float lookup(float phase) const {
+        float pos = phase * Size;
+        int index = int(pos);
+        float frac = pos - index;
+        return _table[index] + (_table[index + 1] - _table[index]) * frac;
+    }
+
+private:
+    float _table[Size + 1];
+};
+
+static const SineTable sineTable;
+
+// polynomial band-limited step correction
+static inline float polyBlep(float t, float dt) {
+    if (t < dt) {
+        t /= dt;
+        return t + t - t * t - 1.f;
+    } else if (t > 1.f - dt) {
+        t = (t - 1.f) / dt;
+        return t * t + t + t + 1.f;
+    }
+    return 0.f;
+}
+
 class Oscillator {
 public:
     enum Waveform {
@@ -19,45 +84,78 @@ public:
     };
 
     Oscillator(float sampleRate) :
-        _sampleRate(sampleRate)
-    {}
+        _invSampleRate(1.f / sampleRate)
+    {
+        setFrequency(_frequency, false);
+    }
 
     Waveform waveform() const { return _waveform; }
     void setWaveform(Waveform waveform) { _waveform = waveform; }
 
     float frequency() const { return _frequency; }
-    void setFrequency(float frequency) {
+    // the frequency is ramped over the next block when smooth is set, otherwise it is applied immediately
+    void setFrequency(float frequency, bool smooth = true) {
         _frequency = frequency;
-        _increment = frequency / _sampleRate;
+        float increment = std::min(0.5f, frequency * _invSampleRate);
+        if (smooth) {
+            _increment.setTarget(increment);
+        } else {
+            _increment.reset(increment);
+        }
     }
 
-    inline float process() {
-        float result = 0.f;
+    void processBlock(float *output, int length) {
+        float increment;
+        float incrementStep = _increment.beginBlock(length, increment);
+        float phase = _phase;
+
         switch (_waveform) {
         case Sine:
-            result = std::sin(TWO_PI * _phase);
+            for (int i = 0; i < length; ++i) {
+                output[i] = sineTable.lookup(phase);
+                phase = advance(phase, increment);
+                increment += incrementStep;
+            }
             break;
         case Triangle:
-            result = 1.f - std::abs(_phase * 4.f - 2.f);
+            for (int i = 0; i < length; ++i) {
+                output[i] = 1.f - std::abs(phase * 4.f - 2.f);
+                phase = advance(phase, increment);
+                increment += incrementStep;
+            }
             break;
         case Sawtooth:
-            result = _phase * 2.f - 1.f;
+            for (int i = 0; i < length; ++i) {
+                output[i] = phase * 2.f - 1.f - polyBlep(phase, increment);
+                phase = advance(phase, increment);
+                increment += incrementStep;
+            }
             break;
         case Square:
-            result = _phase < 0.5f ? -1.f : 1.f;
+            for (int i = 0; i < length; ++i) {
+                float half = phase + 0.5f;
+                half -= half >= 1.f ? 1.f : 0.f;
+                output[i] = (phase < 0.5f ? -1.f : 1.f) - polyBlep(phase, increment) + polyBlep(half, increment);
+                phase = advance(phase, increment);
+                increment += incrementStep;
+            }
             break;
         }
 
-        _phase = std::fmod(_phase + _increment, 1.f);
-        return result;
+        _phase = phase;
     }
 
 private:
-    float _sampleRate;
+    static inline float advance(float phase, float increment) {
+        phase += increment;
+        return phase >= 1.f ? phase - 1.f : phase;
+    }
+
+    float _invSampleRate;
     Waveform _waveform = Sine;
     float _frequency = 100.f;
     float _phase = 0.f;
-    float _increment = 0.f;
+    SmoothedValue _increment;
 };
 
 class Filter {
@@ -79,66 +177,74 @@ public:
     Mode mode() const { return _mode; }
     void setMode(Mode mode) {
         _mode = mode;
+        updateCoefficients();
     }
 
     float frequency() const { return _frequency; }
     void setFrequency(float frequency) {
         _frequency = frequency;
-        _g = std::tan(M_PI * std::max(0.f, std::min(1.f, _frequency * _invSampleRate)));
-
+        _g = std::tan(M_PI * std::max(0.f, std::min(0.49f, _frequency * _invSampleRate)));
+        updateCoefficients();
     }
 
     float resonance() const { return _resonance; }
     void setResonance(float resonance) {
         _resonance = std::max(0.f, std::min(1.f, resonance));
         _k = 2.f - 2.f * _resonance;
+        updateCoefficients();
+    }
+
+    // process block in-place, coefficients are constant over the block
+    void processBlock(float *buffer, int length) {
+        const float a1 = _a1, a2 = _a2, a3 = _a3;
+        const float m0 = _m0, m1 = _m1, m2 = _m2;
+        float ic1eq = _ic1eq;
+        float ic2eq = _ic2eq;
+
+        for (int i = 0; i < length; ++i) {
+            float v0 = buffer[i];
+            float v3 = v0 - ic2eq;
+            float v1 = a1 * ic1eq + a2 * v3;
+            float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+            ic1eq = 2.f * v1 - ic1eq;
+            ic2eq = 2.f * v2 - ic2eq;
+            buffer[i] = m0 * v0 + m1 * v1 + m2 * v2;
+        }
+
+        _ic1eq = flushDenormal(ic1eq);
+        _ic2eq = flushDenormal(ic2eq);
     }
 
-    inline float process(float input) {
-        float a1 = 1.f / (1.f + _g * (_g + _k));
-        float a2 = _g * a1;
-        float a3 = _g * a2;
-        float m0 = 0.f, m1 = 0.f, m2 = 1.f;
+private:
+    void updateCoefficients() {
+        _a1 = 1.f / (1.f + _g * (_g + _k));
+        _a2 = _g * _a1;
+        _a3 = _g * _a2;
 
         switch (_mode) {
         case LowPass:
+            _m0 = 0.f; _m1 = 0.f; _m2 = 1.f;
             break;
         case HighPass:
-            m0 = 1.f;
-            m1 = -_k;
-            m2 = -1.f;
+            _m0 = 1.f; _m1 = -_k; _m2 = -1.f;
             break;
         case BandPass:
-            m1 = 1.f;
-            m2 = 0.f;
+            _m0 = 0.f; _m1 = 1.f; _m2 = 0.f;
             break;
         }
-
-        flushDenormal(input);
-
-        float v0 = input;
-        float v3 = v0 - _ic2eq;
-        float v1 = a1 * _ic1eq + a2 * v3;
-        float v2 = _ic2eq + a2 * _ic1eq + a3 * v3;
-        _ic1eq = 2.f * v1 - _ic1eq;
-        _ic2eq = 2.f * v2 - _ic2eq;
-
-        flushDenormal(_ic1eq);
-        flushDenormal(_ic2eq);
-
-        return m0 * v0 + m1 * v1 + m2 * v2;
     }
 
-private:
     float _invSampleRate;
-    Mode _mode;
-    float _frequency;
-    float _resonance;
+    Mode _mode = LowPass;
+    float _frequency = 0.f;
+    float _resonance = 0.f;
 
     float _ic1eq = 0.f;
     float _ic2eq = 0.f;
-    float _g;
-    float _k;
+    float _g = 0.f;
+    float _k = 2.f;
+    float _a1, _a2, _a3;
+    float _m0, _m1, _m2;
 };
 
 class ADSR {
@@ -166,6 +272,15 @@ public:
         _gate = gate;
     }
 
+    bool idle() const { return _state == Idle && !_gate; }
+
+    void processBlock(float *output, int length) {
+        for (int i = 0; i < length; ++i) {
+            output[i] = process();
+        }
+    }
+
+private:
     inline float process() {
         switch (_state) {
         case Idle:
@@ -216,7 +331,6 @@ public:
         return _value;
     }
 
-private:
     float _invSampleRate;
     float _attack;
     float _decay;
@@ -249,15 +363,32 @@ public:
     }
 
     void setGate(bool gate) {
+        _noteStart = gate && _envVolume.idle();
         _envVolume.setGate(gate);
     }
 
     void setCv(float cv) {
-        _osc.setFrequency(BaseFrequency * std::exp2(cv));
+        if (cv != _cv) {
+            _cv = cv;
+            // only glide while a note is sounding, a new note starts at its pitch
+            _osc.setFrequency(BaseFrequency * std::exp2(cv), !_noteStart && !_envVolume.idle());
+        }
     }
 
-    inline float process() {
-        return _filter.process(_osc.process()) * _envVolume.process() * _gain;
+    void processBlock(float *output, int length) {
+        // skip processing while silent
+        if (_envVolume.idle()) {
+            std::fill(output, output + length, 0.f);
+            return;
+        }
+
+        float env[BlockSize];
+        _osc.processBlock(output, length);
+        _filter.processBlock(output, length);
+        _envVolume.processBlock(env, length);
+        for (int i = 0; i < length; ++i) {
+            output[i] *= env[i] * _gain;
+        }
     }
 
 private:
@@ -266,7 +397,9 @@ private:
     Oscillator _osc;
     Filter _filter;
     ADSR _envVolume;
+    float _cv = -1000.f;
     float _gain = 0.3f;
+    bool _noteStart = false;
 };
 
 
@@ -281,12 +414,11 @@ SynthInstance::~SynthInstance() {
 }
 
 void SynthInstance::getAudio(float *aBuffer, unsigned int aSamples) {
-    for (size_t i = 0; i < aSamples; ++i) {
-        if (i % 128 == 0) {
-            _voice->setGate(_synth._gate);
-            _voice->setCv(_synth._cv);
-        }
-        aBuffer[i] = _voice->process();
+    for (unsigned int offset = 0; offset < aSamples; offset += BlockSize) {
+        int length = std::min(aSamples - offset, (unsigned int)(BlockSize));
+        _voice->setGate(_synth._gate);
+        _voice->setCv(_synth._cv);
+        _voice->processBlock(aBuffer + offset, length);
     }
 }
 
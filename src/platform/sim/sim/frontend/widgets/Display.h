@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Widget.h"
+#include "../LcdImage.h"
 
 #include "nanovg.h"
 
@@ -15,42 +16,40 @@ public:
     Display(const Vector2f &pos, const Vector2f &size, const Vector2i &resolution, const Color &color = Color(0.8f, 0.9f, 0.f, 1.f)) :
         Widget(pos, size),
         _resolution(resolution),
-        _color(color),
-        _frameBuffer(new uint32_t[resolution.prod()])
+        _lcdImage(resolution.x(), resolution.y(), color)
     {
     }
 
     const Vector2i &resolution() { return _resolution; }
 
-    const Color &color() const { return _color; }
-          Color &color()       { return _color; }
+    const Color &color() const { return _lcdImage.color(); }
+    void setColor(const Color &color) { _lcdImage.setColor(color); }
 
     void draw(const uint8_t *frameBuffer) {
-        const uint8_t *src = frameBuffer;
-        uint32_t *dst = _frameBuffer.get();
-        for (int i = 0; i < _resolution.prod(); ++i) {
-            float s = std::min(uint8_t(15), *src++) * (1.f / 15.f);
-            *dst++ = Color(s * _color.r(), s * _color.g(), s * _color.b(), 1.f).rgba();
-        }
-        _frameBufferDirty = true;
+        _lcdImage.update(frameBuffer);
     }
 
+    const LcdImage &lcdImage() const { return _lcdImage; }
+
     virtual void update() override {
     }
 
     virtual void render(Renderer &renderer) override {
         auto nvg = renderer.nvg();
-        const uint8_t *frameBuffer = reinterpret_cast<uint8_t *>(_frameBuffer.get());
+        const uint8_t *frameBuffer = reinterpret_cast<const uint8_t *>(_lcdImage.data());
 
         // update texture
         if (_image == -1) {
             _image = nvgCreateImageRGBA(nvg, _resolution.x(), _resolution.y(), 0 /*NVG_IMAGE_NEAREST*/, frameBuffer);
             _pattern = nvgImagePattern(nvg, _pos.x(), _pos.y(), _size.x(), _size.y(), 0.f, _image, 1.f);;
-        } else {
-            if (_frameBufferDirty) {
-                nvgUpdateImage(nvg, _image, frameBuffer);
-                _frameBufferDirty = false;
-            }
+            _lcdImage.clearDirty();
+        } else if (_lcdImage.dirty()) {
+            // only upload changed rows, the backend takes the full image and offsets into it
+            auto params = nvgInternalParams(nvg);
+            int y = _lcdImage.dirtyBegin();
+            int h = _lcdImage.dirtyEnd() - y;
+            params->renderUpdateTexture(params->userPtr, _image, 0, y, _resolution.x(), h, frameBuffer);
+            _lcdImage.clearDirty();
         }
 
 		nvgBeginPath(nvg);
@@ -64,9 +63,7 @@ public:
 
 private:
     Vector2i _resolution;
-    Color _color;
-    std::unique_ptr<uint32_t[]> _frameBuffer;
-    bool _frameBufferDirty = true;
+    LcdImage _lcdImage;
     int _image = -1;
     NVGpaint _pattern;
 };
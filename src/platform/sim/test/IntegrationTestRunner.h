@@ -71,4 +71,4 @@ if (!(_cond_)) {                                            \
     throw ExpectError();                                    \
 }
 
-#define CURRENT_TIME() HighResolutionTimer::us()
+#define CURRENT_TIME() HighResolutionTimer::hostUs()
@@ -17,4 +17,4 @@ int main() {                            \
     return test::run(_name_) ? 0 : 1;   \
 }                                       \
 
-#define CURRENT_TIME() HighResolutionTimer::us()
+#define CURRENT_TIME() HighResolutionTimer::hostUs()
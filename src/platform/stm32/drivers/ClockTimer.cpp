@@ -3,6 +3,7 @@
 #include "SystemConfig.h"
 
 #include "core/Debug.h"
+#include "core/profiler/IrqProfiler.h"
 
 #include "os/os.h"
 
@@ -58,10 +59,17 @@ void ClockTimer::setListener(Listener *listener) {
 }
 
 void tim5_isr() {
+    // counter runs at 1mhz and was reset by the update event, so it holds the latency in us
+    uint32_t latency = timer_get_counter(TIM5);
+    IrqProfiler::enter(IrqProfiler::Source::ClockTimer);
+    IrqProfiler::latency(IrqProfiler::Source::ClockTimer, latency);
+
     if (timer_get_flag(TIM5, TIM_SR_UIF)) {
         timer_clear_flag(TIM5, TIM_SR_UIF);
         if (g_listener) {
             g_listener->onClockTimerTick();
         }
     }
+
+    IrqProfiler::exit(IrqProfiler::Source::ClockTimer);
 }
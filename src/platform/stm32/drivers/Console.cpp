@@ -3,14 +3,109 @@
 #include "SystemConfig.h"
 
 #include "os/os.h"
-#include "core/utils/RingBuffer.h"
 
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/usart.h>
+#include <libopencm3/stm32/dma.h>
 #include <libopencm3/cm3/nvic.h>
+#include <libopencm3/cm3/cortex.h>
 
 #define CONSOLE_USART USART1
+#define CONSOLE_DMA DMA2
+#define CONSOLE_DMA_STREAM DMA_STREAM7
+#define CONSOLE_DMA_CHANNEL DMA_SxCR_CHSEL_4
+
+static constexpr uint32_t TxBufferSize = CONFIG_CONSOLE_TX_BUFFER_SIZE;
+
+// tx buffer must not be placed in CCMRAM as it is read by DMA
+static char txBuffer[TxBufferSize];
+static volatile uint32_t txRead;
+static volatile uint32_t txWrite;
+static volatile uint32_t txLength;
+static volatile uint32_t txDropped;
+
+static uint32_t txFree() {
+    return (txRead + TxBufferSize - txWrite - 1) % TxBufferSize;
+}
+
+// needs to be called with interrupts disabled
+static void put(char c) {
+    uint32_t write = txWrite;
+    uint32_t next = (write + 1) % TxBufferSize;
+
+    // never block, drop data if the tx buffer is full
+    if (next == txRead) {
+        ++txDropped;
+        return;
+    }
+
+    txBuffer[write] = c;
+    txWrite = next;
+}
+
+// needs to be called with interrupts disabled
+static void putText(char c) {
+    if (c == '\n') {
+        // line endings are written or dropped as a pair
+        if (txFree() < 2) {
+            txDropped += 2;
+            return;
+        }
+        put('\r');
+    }
+    put(c);
+}
+
+// needs to be called with interrupts disabled
+static void startTransfer() {
+    if (txLength != 0) {
+        return;
+    }
+
+    uint32_t read = txRead;
+    uint32_t write = txWrite;
+    if (read == write) {
+        return;
+    }
+
+    // transfer contiguous block up to the end of the buffer
+    uint32_t length = write > read ? write - read : TxBufferSize - read;
+    txLength = length;
+
+    dma_stream_reset(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+    dma_set_peripheral_address(CONSOLE_DMA, CONSOLE_DMA_STREAM, reinterpret_cast<uint32_t>(&USART_DR(CONSOLE_USART)));
+    dma_set_memory_address(CONSOLE_DMA, CONSOLE_DMA_STREAM, reinterpret_cast<uint32_t>(&txBuffer[read]));
+    dma_set_number_of_data(CONSOLE_DMA, CONSOLE_DMA_STREAM, length);
+    dma_channel_select(CONSOLE_DMA, CONSOLE_DMA_STREAM, CONSOLE_DMA_CHANNEL);
+    dma_set_priority(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_SxCR_PL_LOW);
+
+    dma_set_transfer_mode(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+    dma_set_memory_size(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_SxCR_MSIZE_8BIT);
+    dma_set_peripheral_size(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_SxCR_PSIZE_8BIT);
+
+    dma_enable_memory_increment_mode(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+    dma_disable_peripheral_increment_mode(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+
+    dma_enable_transfer_complete_interrupt(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+
+    dma_enable_stream(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+}
+
+// needs to be called with interrupts disabled
+static void finishTransfer() {
+    dma_clear_interrupt_flags(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_TCIF);
+    dma_disable_stream(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+
+    txRead = (txRead + txLength) % TxBufferSize;
+    txLength = 0;
+}
+
+static bool inHandlerMode() {
+    uint32_t ipsr;
+    __asm__ volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr != 0;
+}
 
 void Console::init() {
     // setup GPIO pins
@@ -26,69 +121,85 @@ void Console::init() {
     usart_set_mode(CONSOLE_USART, USART_MODE_TX_RX);
     usart_set_parity(CONSOLE_USART, USART_PARITY_NONE);
     usart_set_flow_control(CONSOLE_USART, USART_FLOWCONTROL_NONE);
+    usart_enable_tx_dma(CONSOLE_USART);
     usart_enable(CONSOLE_USART);
 
-    nvic_set_priority(NVIC_USART1_IRQ, CONFIG_CONSOLE_IRQ_PRIORITY);
-    nvic_enable_irq(NVIC_USART1_IRQ);
+    // setup dma
+    rcc_periph_clock_enable(RCC_DMA2);
+    dma_stream_reset(CONSOLE_DMA, CONSOLE_DMA_STREAM);
+    nvic_set_priority(NVIC_DMA2_STREAM7_IRQ, CONFIG_CONSOLE_IRQ_PRIORITY);
+    nvic_enable_irq(NVIC_DMA2_STREAM7_IRQ);
 }
 
 void Console::write(char c) {
-    if (c == '\n') {
-        send('\r');
-    }
-    send(c);
+    os::InterruptLock lock;
+    putText(c);
+    startTransfer();
 }
 
 void Console::write(const char *s) {
+    os::InterruptLock lock;
     while (*s != '\0') {
-        write(*s++);
+        putText(*s++);
     }
+    startTransfer();
 }
 
 void Console::write(const char *s, size_t length) {
+    os::InterruptLock lock;
     for (size_t i = 0; i < length; ++i) {
-        write(s[i]);
+        putText(s[i]);
     }
+    startTransfer();
 }
 
 void Console::write(const std::string &s) {
-    for (const auto c : s) {
-        write(char(c));
-    }
+    write(s.c_str(), s.size());
 }
 
-static RingBuffer<char, 128> txBuffer;
-static volatile uint32_t txActive;
-
-void Console::send(char c) {
+void Console::writeRaw(const uint8_t *data, size_t length) {
     os::InterruptLock lock;
+    for (size_t i = 0; i < length; ++i) {
+        put(data[i]);
+    }
+    startTransfer();
+}
 
-    // block until there is space in the tx buffer
-    while (txBuffer.full()) {
-        usart_wait_send_ready(CONSOLE_USART);
-        usart_send(CONSOLE_USART, txBuffer.read());
+void Console::flush() {
+    if (!cm_is_masked_interrupts() && !inHandlerMode()) {
+        // tx buffer is drained by the dma interrupt
+        while (txLength != 0) {}
+    } else {
+        // dma interrupt cannot be serviced (interrupts disabled, fault or other interrupt handler), poll the transfers
+        uint32_t mask = cm_mask_interrupts(1);
+        startTransfer();
+        while (txLength != 0) {
+            while (!dma_get_interrupt_flag(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_TCIF)) {}
+            finishTransfer();
+            startTransfer();
+        }
+        cm_mask_interrupts(mask);
     }
 
-    txBuffer.write(c);
+    // wait for the last byte to be shifted out
+    while (!usart_get_flag(CONSOLE_USART, USART_SR_TC)) {}
+}
 
-    // start transmission if necessary
-    if (!txActive) {
-        txActive = 1;
-        usart_wait_send_ready(CONSOLE_USART);
-        usart_send(CONSOLE_USART, txBuffer.read());
-        usart_enable_tx_interrupt(CONSOLE_USART);
-    }
+size_t Console::writable() {
+    return txFree();
+}
+
+uint32_t Console::dropped() {
+    return txDropped;
 }
 
-void usart1_isr() {
+void dma2_stream7_isr() {
     os::InterruptLock lock;
-    if (usart_get_flag(CONSOLE_USART, USART_SR_TXE)) {
-        if (txBuffer.empty()) {
-            usart_disable_tx_interrupt(CONSOLE_USART);
-            txActive = 0;
-        } else {
-            usart_send(CONSOLE_USART, txBuffer.read());
-        }
+    if (dma_get_interrupt_flag(CONSOLE_DMA, CONSOLE_DMA_STREAM, DMA_TCIF)) {
+        finishTransfer();
+
+        // continue with pending data
+        startTransfer();
     }
 }
 
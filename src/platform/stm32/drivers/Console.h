@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include <cstdint>
+
 class Console {
 public:
     static void init();
@@ -11,6 +13,15 @@ public:
     static void write(const char *s, size_t length);
     static void write(const std::string &s);
 
-private:
-    static void send(char c);
+    // write binary data without newline translation
+    static void writeRaw(const uint8_t *data, size_t length);
+
+    // blocks until all buffered data is sent, also works with interrupts disabled and from fault handlers
+    static void flush();
+
+    // number of bytes that can be written without dropping data
+    static size_t writable();
+
+    // number of bytes dropped because the tx buffer was full
+    static uint32_t dropped();
 };
@@ -2,6 +2,8 @@
 
 #include "SystemConfig.h"
 
+#include "core/profiler/IrqProfiler.h"
+
 #include <libopencm3/cm3/nvic.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/exti.h>
@@ -31,6 +33,7 @@ void Dio::init() {
 }
 
 void exti15_10_isr(void) {
+    IrqProfiler::enter(IrqProfiler::Source::Dio);
     if (exti_get_flag_status(EXTI10)) {
         g_dio->resetInput.interrupt();
         exti_reset_request(EXTI10);
@@ -39,4 +42,5 @@ void exti15_10_isr(void) {
         g_dio->clockInput.interrupt();
         exti_reset_request(EXTI11);
     }
+    IrqProfiler::exit(IrqProfiler::Source::Dio);
 }
@@ -5,6 +5,7 @@
 #include <libopencm3/stm32/flash.h>
 
 #include <cstdint>
+#include <cstring>
 
 class Flash {
 public:
@@ -25,4 +26,18 @@ public:
         flash_program_word(address, data);
         flash_wait_for_last_operation();
     }
+
+    static void read(uint32_t address, void *data, size_t len) {
+        std::memcpy(data, reinterpret_cast<const void *>(address), len);
+    }
+
+    static uint32_t sectorAddress(uint32_t sector) {
+        return sector < 4 ? 0x08000000 + sector * 0x4000 :
+               sector < 5 ? 0x08010000 :
+                            0x08020000 + (sector - 5) * 0x20000;
+    }
+
+    static uint32_t sectorSize(uint32_t sector) {
+        return sector < 4 ? 0x4000 : sector < 5 ? 0x10000 : 0x20000;
+    }
 };
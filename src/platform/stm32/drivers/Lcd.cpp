@@ -1,6 +1,7 @@
 #include "Lcd.h"
 
 #include "core/Debug.h"
+#include "core/profiler/IrqProfiler.h"
 
 #include "hal/Delay.h"
 
@@ -141,6 +142,9 @@ void Lcd::draw(uint8_t *frameBuffer) {
     }
 
 
+    // records the frame transfer, with dma it ends in the transfer complete interrupt
+    IrqProfiler::enter(IrqProfiler::Source::Lcd);
+
 #ifdef LCD_USE_DMA
 
     setColAddr(0x1c,0x5b);
@@ -183,6 +187,8 @@ void Lcd::draw(uint8_t *frameBuffer) {
         }
     }
 
+    IrqProfiler::exit(IrqProfiler::Source::Lcd);
+
 #endif // LCD_USE_DMA
 }
 
@@ -239,6 +245,8 @@ void dma1_stream4_isr(void) {
         waitTxDone();
 
         txDone = 1;
+
+        IrqProfiler::exit(IrqProfiler::Source::Lcd);
     }
 }
 #endif // LCD_USE_DMA
@@ -4,6 +4,10 @@
 
 #include "os/os.h"
 
+#include "core/profiler/IrqProfiler.h"
+
+#include <algorithm>
+
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/usart.h>
@@ -38,10 +42,80 @@ void Midi::init() {
 }
 
 bool Midi::send(const MidiMessage &message) {
-    for (uint8_t i = 0; i < message.length(); ++i) {
-        send(message.raw()[i]);
+    os::InterruptLock lock;
+
+    // real-time messages are sent with priority
+    auto &txBuffer = message.isRealTimeMessage() ? _txRealTimeBuffer : _txBuffer;
+
+    // never block, the tx buffer is not drained while a SysEx message is sent
+    if (txBuffer.writable() < message.length()) {
+        ++_txOverflow;
+        return false;
     }
 
+    txBuffer.write(message.raw(), message.length());
+    startTransmit();
+
+    return true;
+}
+
+bool Midi::sendSysEx(const uint8_t *data, size_t length) {
+    if (length < 2 || data[0] != MidiMessage::SystemExclusive || data[length - 1] != MidiMessage::EndOfExclusive) {
+        return false;
+    }
+
+    os::InterruptLock lock;
+
+    // only queue complete messages, a partially queued message would block all other output
+    if (_txSysExOpen || _txSysExBuffer.writable() < length) {
+        return false;
+    }
+
+    _txSysExBuffer.write(data, length);
+    startTransmit();
+
+    return true;
+}
+
+bool Midi::beginSysEx() {
+    os::InterruptLock lock;
+
+    if (_txSysExOpen || _txSysExBuffer.full()) {
+        return false;
+    }
+
+    _txSysExBuffer.write(MidiMessage::SystemExclusive);
+    _txSysExOpen = true;
+    startTransmit();
+
+    return true;
+}
+
+size_t Midi::appendSysEx(const uint8_t *data, size_t length) {
+    os::InterruptLock lock;
+
+    if (!_txSysExOpen) {
+        return 0;
+    }
+
+    length = std::min(length, _txSysExBuffer.writable());
+    _txSysExBuffer.write(data, length);
+    startTransmit();
+
+    return length;
+}
+
+bool Midi::endSysEx() {
+    os::InterruptLock lock;
+
+    if (!_txSysExOpen || _txSysExBuffer.full()) {
+        return false;
+    }
+
+    _txSysExBuffer.write(MidiMessage::EndOfExclusive);
+    _txSysExOpen = false;
+    startTransmit();
+
     return true;
 }
 
@@ -59,34 +133,49 @@ void Midi::setRecvFilter(RecvFilter filter) {
     _recvFilter = filter;
 }
 
-void Midi::send(uint8_t data) {
-    os::InterruptLock lock;
-
-    // block until there is space in the tx buffer
-    while (_txBuffer.full()) {
-        usart_wait_send_ready(MIDI_USART);
-        usart_send(MIDI_USART, _txBuffer.read());
-    }
-
-    _txBuffer.write(data);
+void Midi::setSysExHandler(SysExHandler handler) {
+    _midiParser.setSysExHandler(handler);
+}
 
+void Midi::startTransmit() {
     // start transmission if necessary
-    if (!_txActive) {
+    uint8_t data;
+    if (!_txActive && nextTxByte(data)) {
         _txActive = 1;
         usart_wait_send_ready(MIDI_USART);
-        usart_send(MIDI_USART, _txBuffer.read());
+        usart_send(MIDI_USART, data);
         usart_enable_tx_interrupt(MIDI_USART);
     }
 }
 
+bool Midi::nextTxByte(uint8_t &data) {
+    if (!_txRealTimeBuffer.empty()) {
+        data = _txRealTimeBuffer.read();
+        return true;
+    }
+    // SysEx messages can only be interrupted by real-time messages, other output is held back until
+    // the end byte was sent (also while a streamed message is waiting for more data)
+    if (!_txSysExActive && !_txBuffer.empty()) {
+        data = _txBuffer.read();
+        return true;
+    }
+    if (!_txSysExBuffer.empty()) {
+        data = _txSysExBuffer.read();
+        _txSysExActive = data != MidiMessage::EndOfExclusive;
+        return true;
+    }
+    return false;
+}
+
 void Midi::handleIrq() {
     os::InterruptLock lock;
     if (usart_get_flag(MIDI_USART, USART_SR_TXE)) {
-        if (_txBuffer.empty()) {
+        uint8_t data;
+        if (nextTxByte(data)) {
+            usart_send(MIDI_USART, data);
+        } else {
             usart_disable_tx_interrupt(MIDI_USART);
             _txActive = 0;
-        } else {
-            usart_send(MIDI_USART, _txBuffer.read());
         }
     }
     if (usart_get_flag(MIDI_USART, USART_SR_RXNE)) {
@@ -102,5 +191,7 @@ void Midi::handleIrq() {
 }
 
 void usart6_isr() {
+    IrqProfiler::enter(IrqProfiler::Source::Midi);
     g_midi->handleIrq();
+    IrqProfiler::exit(IrqProfiler::Source::Midi);
 }
@@ -11,24 +11,47 @@
 class Midi {
 public:
     typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef MidiParser::SysExHandler SysExHandler;
+
+    static constexpr size_t SysExTxBufferSize = 256;
 
     void init();
 
+    // queues a message, returns false (and counts the drop) if it does not fit into the buffer
     bool send(const MidiMessage &message);
+    // queues a complete SysEx message (including start/end bytes), returns false if it does not fit into the buffer
+    bool sendSysEx(const uint8_t *data, size_t length);
+
+    // Streaming SysEx send for messages larger than the buffer (i.e. dumps).
+    // beginSysEx() queues the start byte, appendSysEx() queues as many data bytes (< 0x80) as fit into the
+    // buffer and returns their number, endSysEx() queues the end byte. None of them block, begin/end return
+    // false if there is no space (or no message is in progress) and have to be retried. Once the message has
+    // started, other output except real-time messages is held back until the message is ended.
+    bool beginSysEx();
+    size_t appendSysEx(const uint8_t *data, size_t length);
+    bool endSysEx();
     bool recv(MidiMessage *message);
 
     void setRecvFilter(RecvFilter filter);
+    void setSysExHandler(SysExHandler handler);
 
     uint32_t rxOverflow() const { return _rxOverflow; }
+    uint32_t txOverflow() const { return _txOverflow; }
 
     void handleIrq();
 private:
-    void send(uint8_t data);
+    void startTransmit();
+    bool nextTxByte(uint8_t &data);
 
     RingBuffer<uint8_t, 64> _txBuffer;
+    RingBuffer<uint8_t, 16> _txRealTimeBuffer;
+    RingBuffer<uint8_t, SysExTxBufferSize> _txSysExBuffer;
     RingBuffer<uint8_t, 64> _rxBuffer;
     volatile uint32_t _rxOverflow = 0;
+    volatile uint32_t _txOverflow = 0;
     volatile uint32_t _txActive = 0;
+    volatile uint32_t _txSysExActive = 0;
+    bool _txSysExOpen = false;
 
     RecvFilter _recvFilter;
     MidiParser _midiParser;
@@ -4,6 +4,8 @@
 
 #include "os/os.h"
 
+#include "core/profiler/IrqProfiler.h"
+
 #include <libopencm3/stm32/dma.h>
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
@@ -57,26 +59,29 @@ bool SdCard::writeProtected() {
 
 bool SdCard::read(uint8_t *buf, uint32_t sector, uint8_t count) {
     // DBG("read(sector=%d,count=%d)", sector, count);
+    // sdio transfers are polled from the file task, only the duration is recorded
+    IrqProfiler::enter(IrqProfiler::Source::SdCard);
+    bool result = true;
     uint8_t *data = buf;
-    for (uint32_t i = 0; i < count; ++i) {
-        if (!readBlock(sector + i, data)) {
-            return false;
-        }
+    for (uint32_t i = 0; i < count && result; ++i) {
+        result = readBlock(sector + i, data);
         data += 512;
     }
-    return true;
+    IrqProfiler::exit(IrqProfiler::Source::SdCard);
+    return result;
 }
 
 bool SdCard::write(const uint8_t *buf, uint32_t sector, uint8_t count) {
     // DBG("write(sector=%d,count=%d)", sector, count);
+    IrqProfiler::enter(IrqProfiler::Source::SdCard);
+    bool result = true;
     const uint8_t *data = buf;
-    for (uint32_t i = 0; i < count; ++i) {
-        if (!writeBlock(sector + i, data)) {
-            return false;
-        }
+    for (uint32_t i = 0; i < count && result; ++i) {
+        result = writeBlock(sector + i, data);
         data += 512;
     }
-    return true;
+    IrqProfiler::exit(IrqProfiler::Source::SdCard);
+    return result;
 }
 
 bool SdCard::cardDetect() const {
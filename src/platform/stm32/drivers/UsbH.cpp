@@ -62,14 +62,22 @@ struct MidiDriverHandler {
         switch (code) {
         case 0x0: // (1, 2 or 3 bytes) Miscellaneous function codes. Reserved for future extensions.
         case 0x1: // (1, 2 or 3 bytes) Cable events. Reserved for future expansion.
-        case 0x4: // (3 bytes) SysEx starts or continues
-        case 0x6: // (2 bytes) SysEx ends with following two bytes.
-        case 0x7: // (3 bytes) SysEx ends with following three bytes.
             // ignore for now
             return;
+        case 0x4: // (3 bytes) SysEx starts or continues
+        case 0x7: // (3 bytes) SysEx ends with following three bytes.
+            g_usbh->midiEnqueueSysEx(device, &data[1], 3);
+            break;
+        case 0x6: // (2 bytes) SysEx ends with following two bytes.
+            g_usbh->midiEnqueueSysEx(device, &data[1], 2);
+            break;
         case 0x5: // (1 bytes) Single-byte System Common Message or SysEx ends with following single byte.
-            message = MidiMessage(data[1]);
-            g_usbh->midiEnqueueMessage(device, message);
+            if (data[1] == MidiMessage::EndOfExclusive) {
+                g_usbh->midiEnqueueSysEx(device, &data[1], 1);
+            } else {
+                message = MidiMessage(data[1]);
+                g_usbh->midiEnqueueMessage(device, message);
+            }
             break;
         case 0x2: // (2 bytes) Two-byte System Common messages like MTC, SongSelect, etc.
         case 0xC: // (2 bytes) Program Change
@@ -103,6 +111,19 @@ struct MidiDriverHandler {
         usbh_midi_write(device, data, 4, &writeCallback);
     }
 
+    static void writeSysEx(uint8_t device, const uint8_t *sysEx, size_t length) {
+        uint8_t data[4] = { 0, 0, 0, 0 };
+
+        // code index 0x4 continues the message, 0x5-0x7 end it with 1-3 bytes
+        bool end = sysEx[length - 1] == MidiMessage::EndOfExclusive;
+        data[0] = end ? 0x4 + length : 0x4;
+        for (size_t i = 0; i < length; ++i) {
+            data[1 + i] = sysEx[i];
+        }
+
+        usbh_midi_write(device, data, 4, &writeCallback);
+    }
+
     static void writeCallback(uint8_t bytes_written) {
     }
 };
@@ -153,10 +174,16 @@ void UsbH::process() {
     // Start sending MIDI messages
     uint8_t device;
     MidiMessage message;
+    uint8_t sysEx[3];
+    size_t sysExLength;
     if (midiDequeueMessage(&device, &message)) {
         if (midiDeviceConnected(device)) {
             MidiDriverHandler::write(device, message);
         }
+    } else if ((sysExLength = midiDequeueSysEx(&device, sysEx)) > 0) {
+        if (midiDeviceConnected(device)) {
+            MidiDriverHandler::writeSysEx(device, sysEx, sysExLength);
+        }
     }
 }
 
@@ -35,6 +35,10 @@ private:
         _usbMidi.enqueueMessage(message);
     }
 
+    void midiEnqueueSysEx(uint8_t device, const uint8_t *data, size_t length) {
+        _usbMidi.enqueueSysEx(data, length);
+    }
+
     void midiEnqueueData(uint8_t device, uint8_t data) {
         _usbMidi.enqueueData(data);
     }
@@ -44,6 +48,11 @@ private:
         return _usbMidi.dequeueMessage(message);
     }
 
+    size_t midiDequeueSysEx(uint8_t *device, uint8_t *data) {
+        *device = 0;
+        return _usbMidi.dequeueSysEx(data);
+    }
+
     UsbMidi &_usbMidi;
 
     uint8_t _midiDevices = 0;
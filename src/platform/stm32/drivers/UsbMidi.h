@@ -2,7 +2,9 @@
 
 #include "core/utils/RingBuffer.h"
 #include "core/midi/MidiMessage.h"
+#include "core/midi/MidiParser.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <cstdint>
@@ -12,18 +14,73 @@ public:
     typedef std::function<void(uint16_t vendorId, uint16_t productId)> ConnectHandler;
     typedef std::function<void()> DisconnectHandler;
     typedef std::function<bool(uint8_t)> RecvFilter;
+    typedef MidiParser::SysExHandler SysExHandler;
+
+    static constexpr size_t SysExTxBufferSize = 256;
 
     void init() {}
 
     bool send(const MidiMessage &message) {
-        if (_txQueue.full()) {
+        // real-time messages are sent with priority
+        if (message.isRealTimeMessage()) {
+            if (_txRealTimeQueue.full()) {
+                return false;
+            }
+            _txRealTimeQueue.write(message);
+        } else {
+            if (_txQueue.full()) {
+                return false;
+            }
+            _txQueue.write(message);
+        }
+        return true;
+    }
+
+    // queues a complete SysEx message (including start/end bytes), returns false if it does not fit into the buffer
+    bool sendSysEx(const uint8_t *data, size_t length) {
+        if (length < 2 || data[0] != MidiMessage::SystemExclusive || data[length - 1] != MidiMessage::EndOfExclusive ||
+            _txSysExOpen || _txSysExQueue.writable() < length) {
+            return false;
+        }
+        _txSysExQueue.write(data, length);
+        // publish the end of the message after it was written completely
+        _txSysExEnded = _txSysExEnded + 1;
+        return true;
+    }
+
+    // streaming SysEx send, see Midi::beginSysEx()
+    bool beginSysEx() {
+        if (_txSysExOpen || _txSysExQueue.full()) {
+            return false;
+        }
+        _txSysExQueue.write(MidiMessage::SystemExclusive);
+        _txSysExOpen = true;
+        return true;
+    }
+
+    size_t appendSysEx(const uint8_t *data, size_t length) {
+        if (!_txSysExOpen) {
+            return 0;
+        }
+        length = std::min(length, _txSysExQueue.writable());
+        _txSysExQueue.write(data, length);
+        return length;
+    }
+
+    bool endSysEx() {
+        if (!_txSysExOpen || _txSysExQueue.full()) {
             return false;
         }
-        _txQueue.write(message);
+        _txSysExQueue.write(MidiMessage::EndOfExclusive);
+        _txSysExOpen = false;
+        _txSysExEnded = _txSysExEnded + 1;
         return true;
     }
 
     bool recv(MidiMessage *message) {
+        while (!_rxSysExQueue.empty()) {
+            _sysExParser.feed(_rxSysExQueue.read());
+        }
         if (_rxQueue.empty()) {
             return false;
         }
@@ -43,6 +100,10 @@ public:
         _recvFilter = filter;
     }
 
+    void setSysExHandler(SysExHandler handler) {
+        _sysExParser.setSysExHandler(handler);
+    }
+
     uint32_t rxOverflow() const { return 0; }
 
 private:
@@ -66,6 +127,29 @@ private:
         _rxQueue.write(message);
     }
 
+    void enqueueSysEx(const uint8_t *data, size_t length) {
+        while (length--) {
+            uint8_t byte = *data++;
+            if (_rxSysExDropping) {
+                // drop the rest of an overflown message
+                if (byte != MidiMessage::SystemExclusive) {
+                    continue;
+                }
+                _rxSysExDropping = false;
+            }
+            // the last entry is reserved to mark an overflown message as aborted
+            if (_rxSysExQueue.writable() < 2) {
+                ++_rxOverflow;
+                if (!_rxSysExQueue.full()) {
+                    _rxSysExQueue.write(uint8_t(MidiParser::SysExAbort));
+                }
+                _rxSysExDropping = true;
+                continue;
+            }
+            _rxSysExQueue.write(byte);
+        }
+    }
+
     void enqueueData(uint8_t data) {
         if (_recvFilter && !_recvFilter(data)) {
             // _recvFilter(data);
@@ -73,20 +157,53 @@ private:
     }
 
     bool dequeueMessage(MidiMessage *message) {
-        if (_txQueue.empty()) {
+        if (!_txRealTimeQueue.empty()) {
+            *message = _txRealTimeQueue.read();
+            return true;
+        }
+        // SysEx messages can only be interrupted by real-time messages, other output is held back until the end byte was sent
+        if (_txSysExActive || _txQueue.empty()) {
             return false;
         }
         *message = _txQueue.read();
         return true;
     }
 
+    // dequeues up to 3 bytes of the current SysEx message (one USB MIDI event packet)
+    size_t dequeueSysEx(uint8_t *data) {
+        // a packet is sent once it is complete, only the last packet of a message can be shorter
+        if (_txSysExQueue.readable() < 3 && _txSysExSent == _txSysExEnded) {
+            return 0;
+        }
+        size_t length = 0;
+        while (length < 3) {
+            data[length] = _txSysExQueue.read();
+            _txSysExActive = data[length++] != MidiMessage::EndOfExclusive;
+            if (!_txSysExActive) {
+                ++_txSysExSent;
+                break;
+            }
+        }
+        return length;
+    }
+
     ConnectHandler _connectHandler;
     DisconnectHandler _disconnectHandler;
     RecvFilter _recvFilter;
 
     RingBuffer<MidiMessage, 128> _txQueue;
+    RingBuffer<MidiMessage, 16> _txRealTimeQueue;
+    RingBuffer<uint8_t, SysExTxBufferSize> _txSysExQueue;
     RingBuffer<MidiMessage, 16> _rxQueue;
+    RingBuffer<uint8_t, 128> _rxSysExQueue;
     volatile uint32_t _rxOverflow = 0;
+    bool _rxSysExDropping = false;
+    volatile uint32_t _txSysExEnded = 0;
+    uint32_t _txSysExSent = 0;
+    bool _txSysExActive = false;
+    bool _txSysExOpen = false;
+
+    MidiParser _sysExParser;
 
     friend class UsbH;
 };
@@ -99,6 +99,12 @@ namespace os {
     inline void resume(TaskHandle handle) { vTaskResume(handle); }
     inline void resumeFromISR(TaskHandle handle) { xTaskResumeFromISR(handle); }
 
+    inline bool inInterrupt() {
+        uint32_t ipsr;
+        __asm__ volatile ("mrs %0, ipsr" : "=r" (ipsr));
+        return ipsr != 0;
+    }
+
     namespace this_task {
 
         inline TaskHandle handle() { return xTaskGetCurrentTaskHandle(); }
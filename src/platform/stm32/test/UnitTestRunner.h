@@ -29,8 +29,12 @@ int runWrapper(const char *name) {
     return 0;
 }
 
+// flush after each message, test output exceeds the console tx buffer
 #define UNIT_TEST_RUNNER_PRINTF(_fmt_, ...) \
-    dbg_printf(_fmt_, ##__VA_ARGS__)
+    do {                                    \
+        dbg_printf(_fmt_, ##__VA_ARGS__);   \
+        Console::flush();                   \
+    } while (0)
 
 #define UNIT_TEST_RUNNER(_name_)        \
     int main() {                        \
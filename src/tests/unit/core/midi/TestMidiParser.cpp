@@ -0,0 +1,110 @@
+#include "UnitTest.h"
+
+#include "core/midi/MidiParser.h"
+
+#include <vector>
+
+#include <cstdint>
+
+struct SysExRecorder {
+    std::vector<uint8_t> data;
+    int chunks = 0;
+    int firstChunks = 0;
+    int lastChunks = 0;
+    int abortedChunks = 0;
+
+    void attach(MidiParser &parser) {
+        parser.setSysExHandler([this] (const MidiParser::SysExChunk &chunk) {
+            data.insert(data.end(), chunk.data, chunk.data + chunk.length);
+            ++chunks;
+            firstChunks += chunk.first ? 1 : 0;
+            lastChunks += chunk.last ? 1 : 0;
+            abortedChunks += chunk.aborted ? 1 : 0;
+        });
+    }
+};
+
+static int feed(MidiParser &parser, const std::vector<uint8_t> &data) {
+    int messages = 0;
+    for (auto byte : data) {
+        messages += parser.feed(byte) ? 1 : 0;
+    }
+    return messages;
+}
+
+UNIT_TEST("MidiParser") {
+
+    CASE("channel messages") {
+        MidiParser parser;
+        expectEqual(feed(parser, { 0x90, 60, 100 }), 1);
+        expectTrue(parser.message().isNoteOn());
+        expectEqual(int(parser.message().note()), 60);
+        // running status
+        expectEqual(feed(parser, { 62, 0 }), 1);
+        expectEqual(int(parser.message().note()), 62);
+    }
+
+    CASE("short sysex") {
+        MidiParser parser;
+        SysExRecorder recorder;
+        recorder.attach(parser);
+        std::vector<uint8_t> message = { 0xf0, 0x7d, 0x01, 0x02, 0xf7 };
+        expectEqual(feed(parser, message), 0);
+        expectTrue(recorder.data == message);
+        expectEqual(recorder.chunks, 1);
+        expectEqual(recorder.firstChunks, 1);
+        expectEqual(recorder.lastChunks, 1);
+        expectEqual(recorder.abortedChunks, 0);
+    }
+
+    CASE("long sysex is chunked") {
+        MidiParser parser;
+        SysExRecorder recorder;
+        recorder.attach(parser);
+        std::vector<uint8_t> message = { 0xf0 };
+        for (int i = 0; i < 100; ++i) {
+            message.push_back(i);
+        }
+        message.push_back(0xf7);
+        expectEqual(feed(parser, message), 0);
+        expectTrue(recorder.data == message);
+        expectEqual(recorder.chunks, int((message.size() + MidiParser::SysExChunkSize - 1) / MidiParser::SysExChunkSize));
+        expectEqual(recorder.firstChunks, 1);
+        expectEqual(recorder.lastChunks, 1);
+    }
+
+    CASE("real-time messages inside sysex") {
+        MidiParser parser;
+        SysExRecorder recorder;
+        recorder.attach(parser);
+        expectEqual(feed(parser, { 0xf0, 0x01, 0xf8, 0x02, 0xf7 }), 1);
+        expectTrue(recorder.data == std::vector<uint8_t>({ 0xf0, 0x01, 0x02, 0xf7 }));
+        expectEqual(recorder.abortedChunks, 0);
+    }
+
+    CASE("interrupted sysex") {
+        MidiParser parser;
+        SysExRecorder recorder;
+        recorder.attach(parser);
+        expectEqual(feed(parser, { 0xf0, 0x01, 0x02, 0x90, 60, 100 }), 1);
+        expectTrue(parser.message().isNoteOn());
+        expectEqual(recorder.lastChunks, 1);
+        expectEqual(recorder.abortedChunks, 1);
+        // a new sysex message aborts the unterminated one
+        expectEqual(feed(parser, { 0xf0, 0x01, 0xf0, 0x02, 0xf7 }), 0);
+        expectEqual(recorder.firstChunks, 3);
+        expectEqual(recorder.abortedChunks, 2);
+        expectEqual(recorder.lastChunks, 3);
+    }
+
+    CASE("undefined system common aborts sysex") {
+        MidiParser parser;
+        SysExRecorder recorder;
+        recorder.attach(parser);
+        expectEqual(feed(parser, { 0xf0, 0x01, 0x02, MidiParser::SysExAbort, 0x03, 0xf7 }), 0);
+        expectTrue(recorder.data == std::vector<uint8_t>({ 0xf0, 0x01, 0x02 }));
+        expectEqual(recorder.lastChunks, 1);
+        expectEqual(recorder.abortedChunks, 1);
+    }
+
+}
@@ -0,0 +1,63 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/model/Calibration.cpp"
+
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+
+// reference implementation interpolating between items in floating point
+static uint16_t voltsToValueFloat(const Calibration::CvOutput &cvOutput, float volts) {
+    using CvOutput = Calibration::CvOutput;
+    volts = clamp(volts, float(CvOutput::MinVoltage), float(CvOutput::MaxVoltage));
+    float fIndex = (volts - CvOutput::MinVoltage) * CvOutput::ItemsPerVolt;
+    int index = std::floor(fIndex);
+    if (index < CvOutput::ItemCount - 1) {
+        float t = fIndex - index;
+        return lerp(t, cvOutput.item(index), cvOutput.item(index + 1));
+    } else {
+        return cvOutput.item(CvOutput::ItemCount - 1);
+    }
+}
+
+static int maxError(const Calibration::CvOutput &cvOutput) {
+    int error = 0;
+    for (int step = -65536 * 6; step <= 65536 * 6; step += 7) {
+        float volts = step * (1.f / 65536.f);
+        error = std::max(error, std::abs(int(cvOutput.voltsToValue(volts)) - int(voltsToValueFloat(cvOutput, volts))));
+    }
+    return error;
+}
+
+UNIT_TEST("Calibration") {
+
+    CASE("default calibration") {
+        Calibration::CvOutput cvOutput;
+        cvOutput.clear();
+        expect(maxError(cvOutput) <= 1);
+    }
+
+    CASE("user calibration") {
+        Calibration::CvOutput cvOutput;
+        cvOutput.clear();
+        cvOutput.setItem(0, 32767);
+        cvOutput.setUserDefined(0, true);
+        cvOutput.setItem(3, cvOutput.item(3) + 321);
+        cvOutput.setUserDefined(3, true);
+        cvOutput.setItem(7, cvOutput.item(7) - 1234);
+        cvOutput.setUserDefined(7, true);
+        cvOutput.setItem(10, 0);
+        cvOutput.setUserDefined(10, true);
+        expect(maxError(cvOutput) <= 1);
+    }
+
+    CASE("calibration points") {
+        Calibration::CvOutput cvOutput;
+        cvOutput.clear();
+        for (int index = 0; index < Calibration::CvOutput::ItemCount; ++index) {
+            float volts = Calibration::CvOutput::itemToVolts(index);
+            expectEqual(int(cvOutput.voltsToValue(volts)), cvOutput.item(index));
+        }
+    }
+
+}
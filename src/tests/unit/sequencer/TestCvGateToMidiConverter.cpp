@@ -0,0 +1,171 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/CvGateToMidiConverter.cpp"
+
+#include <array>
+#include <vector>
+
+#include <cstdint>
+
+static const CvGateToMidiConverter::Voice MonoVoices[] = { { 0, 1, 0 } };
+static const CvGateToMidiConverter::Voice PolyVoices[] = { { 0, 1, 0 }, { 2, 3, 0 } };
+
+struct ConverterHarness {
+    CvGateToMidiConverter converter;
+    std::array<float, CONFIG_CV_INPUT_CHANNELS> channels;
+    std::vector<CvGateToMidiConverter::Event> events;
+    uint32_t tick = 0;
+
+    ConverterHarness(const CvGateToMidiConverter::Voice *voices, int count) {
+        channels.fill(0.f);
+        converter.setVoices(voices, count, 0);
+    }
+
+    // sets pitch (in semitones relative to C4) and gate of a voice
+    void set(int voice, float semitones, bool gate) {
+        channels[voice * 2] = semitones / 12.f;
+        channels[voice * 2 + 1] = gate ? 5.f : 0.f;
+    }
+
+    void update(int count = 1) {
+        for (int i = 0; i < count; ++i) {
+            converter.process(channels.data(), tick);
+            CvGateToMidiConverter::Event event;
+            while (converter.read(event)) {
+                events.push_back(event);
+            }
+            ++tick;
+        }
+    }
+
+    int countNoteOn() const {
+        int count = 0;
+        for (const auto &event : events) {
+            count += event.message.isNoteOn() ? 1 : 0;
+        }
+        return count;
+    }
+
+    int countNoteOff() const {
+        int count = 0;
+        for (const auto &event : events) {
+            count += event.message.isNoteOff() ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+UNIT_TEST("CvGateToMidiConverter") {
+
+    CASE("gate on/off") {
+        ConverterHarness h(MonoVoices, 1);
+        h.set(0, 7.f, false);
+        h.update(5);
+        h.set(0, 7.f, true);
+        h.update(5);
+        h.set(0, 7.f, false);
+        h.update(5);
+        expectEqual(int(h.events.size()), 2);
+        expectTrue(h.events[0].message.isNoteOn());
+        expectEqual(int(h.events[0].message.note()), 67);
+        expectEqual(int(h.events[0].tick), 5);
+        expectTrue(h.events[1].message.isNoteOff());
+        expectEqual(int(h.events[1].message.note()), 67);
+        expectEqual(int(h.events[1].tick), 10);
+    }
+
+    CASE("gate hysteresis") {
+        ConverterHarness h(MonoVoices, 1);
+        h.update();
+        // gate voltages between the off and on threshold do not change the gate
+        for (int i = 0; i < 10; ++i) {
+            h.channels[1] = (i % 2) ? 3.5f : 2.5f;
+            h.update();
+        }
+        expectEqual(h.countNoteOn(), 1);
+        expectEqual(h.countNoteOff(), 0);
+    }
+
+    CASE("pitch hysteresis") {
+        ConverterHarness h(MonoVoices, 1);
+        h.set(0, 0.45f, true);
+        h.update(5);
+        // jitter around the note boundary does not retrigger
+        for (int i = 0; i < 20; ++i) {
+            h.set(0, (i % 2) ? 0.46f : 0.54f, true);
+            h.update();
+        }
+        expectEqual(h.countNoteOn(), 1);
+        // a settled pitch beyond the hysteresis changes the note
+        h.set(0, 1.f, true);
+        h.update(5);
+        expectEqual(h.countNoteOn(), 2);
+        expectEqual(h.countNoteOff(), 1);
+        expectEqual(int(h.events[1].message.note()), 61);
+        expectEqual(int(h.events[2].message.note()), 60);
+    }
+
+    CASE("glide") {
+        ConverterHarness h(MonoVoices, 1);
+        h.set(0, 0.f, true);
+        h.update(5);
+        // glide an octave up, intermediate notes are skipped
+        for (int i = 1; i <= 100; ++i) {
+            h.set(0, i * 0.12f, true);
+            h.update();
+        }
+        h.update(5);
+        expectEqual(h.countNoteOn(), 2);
+        expectEqual(h.countNoteOff(), 1);
+        expectEqual(int(h.events[1].message.note()), 72);
+    }
+
+    CASE("gate on during pitch change") {
+        ConverterHarness h(MonoVoices, 1);
+        h.set(0, 0.f, false);
+        h.update(5);
+        // pitch settles one update after the gate, note on is timestamped with the gate
+        h.set(0, 5.f, true);
+        h.update();
+        h.set(0, 12.f, true);
+        h.update(5);
+        expectEqual(int(h.events.size()), 1);
+        expectEqual(int(h.events[0].message.note()), 72);
+        expectEqual(int(h.events[0].tick), 5);
+    }
+
+    CASE("polyphony") {
+        ConverterHarness h(PolyVoices, 2);
+        h.set(0, 0.f, true);
+        h.set(1, 4.f, true);
+        h.update(5);
+        expectEqual(h.countNoteOn(), 2);
+        // both voices playing the same note result in a single note
+        h.set(1, 0.f, true);
+        h.update(5);
+        expectEqual(h.countNoteOn(), 2);
+        expectEqual(h.countNoteOff(), 1);
+        h.set(0, 0.f, false);
+        h.update(5);
+        expectEqual(h.countNoteOff(), 1);
+        h.set(1, 0.f, false);
+        h.update(5);
+        expectEqual(h.countNoteOff(), 2);
+        expectEqual(int(h.events.back().message.note()), 60);
+    }
+
+    CASE("release on voice change") {
+        ConverterHarness h(PolyVoices, 2);
+        h.set(0, 0.f, true);
+        h.set(1, 4.f, true);
+        h.update(5);
+        h.converter.setVoices(MonoVoices, 1, h.tick);
+        CvGateToMidiConverter::Event event;
+        int noteOffs = 0;
+        while (h.converter.read(event)) {
+            noteOffs += event.message.isNoteOff() ? 1 : 0;
+        }
+        expectEqual(noteOffs, 2);
+    }
+
+}
@@ -0,0 +1,142 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/model/FlashJournal.cpp"
+
+#include <array>
+
+#include <cstdint>
+
+static const uint32_t Sector0 = 3;
+static const uint32_t Sector1 = 11;
+
+static void eraseAll() {
+    Flash::eraseSector(Sector0);
+    Flash::eraseSector(Sector1);
+}
+
+static bool readLatest(std::array<uint8_t, 64> &data, size_t &length) {
+    FlashJournal journal(Sector0, Sector1);
+    uint32_t address;
+    if (!journal.latest(address, length)) {
+        return false;
+    }
+    Flash::read(address, data.data(), length);
+    return true;
+}
+
+static std::array<uint8_t, 64> makeData(int seed) {
+    std::array<uint8_t, 64> data;
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = seed + i;
+    }
+    return data;
+}
+
+UNIT_TEST("FlashJournal") {
+
+    CASE("empty") {
+        eraseAll();
+        FlashJournal journal(Sector0, Sector1);
+        uint32_t address;
+        size_t length;
+        expectFalse(journal.latest(address, length));
+    }
+
+    CASE("append") {
+        eraseAll();
+        for (int i = 0; i < 10; ++i) {
+            FlashJournal journal(Sector0, Sector1);
+            auto data = makeData(i);
+            expectTrue(journal.append(data.data(), 10 + i));
+            // only the first record needs an erase
+            expectEqual(journal.erases(), i == 0 ? 1 : 0);
+
+            std::array<uint8_t, 64> latest;
+            size_t length;
+            expectTrue(readLatest(latest, length));
+            expectEqual(int(length), 10 + i);
+            expectTrue(std::equal(data.begin(), data.begin() + length, latest.begin()));
+        }
+    }
+
+    CASE("garbage collection") {
+        eraseAll();
+        FlashJournal journal(Sector0, Sector1);
+        // sector 0 holds (16K - 12) / 72 = 227 records of 64 bytes, sector 1 a lot more
+        int erases = 0;
+        for (int i = 0; i < 1000; ++i) {
+            auto data = makeData(i);
+            expectTrue(journal.append(data.data(), data.size()));
+            std::array<uint8_t, 64> latest;
+            size_t length;
+            expectTrue(readLatest(latest, length));
+            expectTrue(latest == data);
+            erases = journal.erases();
+        }
+        // starts in sector 1 (1820 records), nothing to collect yet
+        expectEqual(erases, 1);
+        for (int i = 1000; i < 2500; ++i) {
+            auto data = makeData(i);
+            expectTrue(journal.append(data.data(), data.size()));
+        }
+        // switched to sector 0 and back to sector 1
+        expectEqual(journal.erases(), 3);
+        std::array<uint8_t, 64> latest;
+        size_t length;
+        expectTrue(readLatest(latest, length));
+        expectTrue(latest == makeData(2499));
+    }
+
+    CASE("power loss") {
+        eraseAll();
+        {
+            FlashJournal journal(Sector0, Sector1);
+            auto data = makeData(1);
+            journal.append(data.data(), data.size());
+        }
+
+        // record header written but data missing
+        {
+            FlashJournal journal(Sector0, Sector1);
+            uint32_t address;
+            size_t length;
+            journal.latest(address, length);
+            uint32_t next = address + length;
+            Flash::program(next, 64);
+            Flash::program(next + 4, 0x12345678);
+            Flash::program(next + 8, 0);
+        }
+
+        std::array<uint8_t, 64> latest;
+        size_t length;
+        expectTrue(readLatest(latest, length));
+        expectTrue(latest == makeData(1));
+
+        // journal continues after the broken record
+        {
+            FlashJournal journal(Sector0, Sector1);
+            auto data = makeData(2);
+            journal.append(data.data(), data.size());
+            expectEqual(journal.erases(), 0);
+        }
+        expectTrue(readLatest(latest, length));
+        expectTrue(latest == makeData(2));
+    }
+
+    CASE("power loss during garbage collection") {
+        eraseAll();
+        FlashJournal journal(Sector0, Sector1);
+        auto data = makeData(1);
+        journal.append(data.data(), data.size());
+
+        // other sector erased and record written, but sector header not committed
+        Flash::eraseSector(Sector0);
+        Flash::program(Flash::sectorAddress(Sector0) + 12, 64);
+
+        std::array<uint8_t, 64> latest;
+        size_t length;
+        expectTrue(readLatest(latest, length));
+        expectTrue(latest == makeData(1));
+    }
+
+}
@@ -0,0 +1,48 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/MidiLog.h"
+
+#include <cstdint>
+
+UNIT_TEST("MidiLog") {
+
+    CASE("empty") {
+        MidiLog log;
+        MidiLog::Entry entry;
+        expectEqual(int(log.writeIndex()), 0);
+        expectFalse(log.read(log.writeIndex() - 1, entry));
+        expectFalse(log.read(0, entry));
+    }
+
+    CASE("write/read") {
+        MidiLog log;
+        for (int i = 0; i < 10; ++i) {
+            log.write(i * 10, MidiPort::UsbMidi, MidiMessage::makeNoteOn(0, 60 + i));
+        }
+        expectEqual(int(log.writeIndex()), 10);
+        MidiLog::Entry entry;
+        for (uint32_t index = 0; index < 10; ++index) {
+            expectTrue(log.read(index, entry));
+            expectEqual(int(entry.tick), int(index * 10));
+            expectTrue(entry.port == MidiPort::UsbMidi);
+            expectEqual(int(entry.message.note()), int(60 + index));
+        }
+        expectFalse(log.read(10, entry));
+    }
+
+    CASE("overwrite") {
+        MidiLog log;
+        for (int i = 0; i < 200; ++i) {
+            log.write(i, MidiPort::Midi, MidiMessage::makeNoteOn(0, i % 128));
+        }
+        // the oldest entries are overwritten, one slot is reserved for the entry being written
+        MidiLog::Entry entry;
+        int available = 0;
+        for (uint32_t index = log.writeIndex(); log.read(index - 1, entry); --index) {
+            expectEqual(int(entry.tick), int(index - 1));
+            ++available;
+        }
+        expectEqual(available, int(MidiLog::Size) - 1);
+    }
+
+}
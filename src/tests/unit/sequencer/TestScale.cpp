@@ -6,7 +6,10 @@
 #include "apps/sequencer/model/UserScale.cpp"
 
 #include <array>
+#include <functional>
+
 #include <cstdint>
+#include <cmath>
 
 UNIT_TEST("Scale") {
 
@@ -62,6 +65,63 @@ UNIT_TEST("Scale") {
         }
     }
 
+    CASE("noteFromVolts matches linear search") {
+        // reference quantization by scanning the notes of an octave
+        auto scan = [] (float volts, float octaveRange, int notesPerOctave, int size, std::function<float(int)> noteVolts) {
+            int octave = int(std::floor(volts / octaveRange));
+            float fractional = volts - octave * octaveRange;
+            int index = -1;
+            for (int i = 0; i < size; ++i) {
+                if (fractional < noteVolts(i)) {
+                    break;
+                }
+                index = i;
+            }
+            if (index == -1) {
+                index = size - 1;
+                --octave;
+            }
+            return octave * notesPerOctave + index;
+        };
+
+        // builtin note scales (excluding voltage scale and user scales)
+        for (int i = 0; i < Scale::Count - 5; ++i) {
+            const auto &scale = Scale::get(i);
+            int notesPerOctave = scale.notesPerOctave();
+            for (int step = -4987; step <= 4987; ++step) {
+                float volts = step * (1.f / 997.f);
+                int expected = scan(volts + 0.01f, 1.f, notesPerOctave, notesPerOctave, [&] (int index) { return scale.noteToVolts(index); });
+                expectEqual(scale.noteFromVolts(volts), expected);
+            }
+        }
+
+        UserScale userScale;
+
+        // chromatic mode with unsorted items
+        userScale.setMode(UserScale::Mode::Chromatic);
+        userScale.setSize(5);
+        for (int i = 0; i < 5; ++i) {
+            userScale.setItem(i, std::array<int, 5>{{ 2, 7, 4, 9, 11 }}[i]);
+        }
+        for (int step = -120; step <= 120; ++step) {
+            float volts = step * (1.f / 12.f);
+            int expected = scan(std::floor(volts * 12.f + 0.01f), 12.f, 5, 5, [&] (int index) { return float(userScale.item(index)); });
+            expectEqual(userScale.noteFromVolts(volts), expected);
+        }
+
+        // voltage mode
+        userScale.setMode(UserScale::Mode::Voltage);
+        userScale.setSize(4);
+        for (int i = 0; i < 4; ++i) {
+            userScale.setItem(i, std::array<int, 4>{{ -250, 100, 50, 1250 }}[i]);
+        }
+        for (int step = -4987; step <= 4987; ++step) {
+            float volts = step * (1.f / 997.f);
+            int expected = scan(std::floor(volts * 1000.f), 1500.f, 3, 4, [&] (int index) { return float(userScale.item(index)); });
+            expectEqual(userScale.noteFromVolts(volts), expected);
+        }
+    }
+
 #ifdef PLATFORM_SIM
 
     CASE("markdown") {
@@ -0,0 +1,54 @@
+#include "UnitTest.h"
+
+#include "sim/frontend/LcdImage.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <cstdint>
+
+static constexpr int Width = 256;
+static constexpr int Height = 64;
+
+// returns the number of rows converted by updating the image with the frame
+static int convert(sim::LcdImage &lcdImage, const std::vector<uint8_t> &frame) {
+    uint32_t rows = lcdImage.convertedRows();
+    lcdImage.clearDirty();
+    lcdImage.update(frame.data());
+    return int(lcdImage.convertedRows() - rows);
+}
+
+UNIT_TEST("LcdImage") {
+
+    CASE("initial conversion") {
+        sim::LcdImage lcdImage(Width, Height, sim::Color(1.f, 1.f));
+        expectEqual(int(lcdImage.convertedRows()), Height);
+    }
+
+    CASE("idle frame") {
+        sim::LcdImage lcdImage(Width, Height, sim::Color(1.f, 1.f));
+        std::vector<uint8_t> frame(Width * Height, 0);
+        expectEqual(convert(lcdImage, frame), 0);
+        expectFalse(lcdImage.dirty());
+    }
+
+    CASE("single row") {
+        sim::LcdImage lcdImage(Width, Height, sim::Color(1.f, 1.f));
+        std::vector<uint8_t> frame(Width * Height, 0);
+        frame[10 * Width + 5] = 15;
+        expectEqual(convert(lcdImage, frame), 1);
+        expectEqual(lcdImage.dirtyBegin(), 10);
+        expectEqual(lcdImage.dirtyEnd(), 11);
+        expectEqual(int(lcdImage.data()[10 * Width + 5]), int(sim::Color(1.f, 1.f).rgba()));
+    }
+
+    CASE("full redraw") {
+        sim::LcdImage lcdImage(Width, Height, sim::Color(1.f, 1.f));
+        std::vector<uint8_t> frame(Width * Height, 7);
+        expectEqual(convert(lcdImage, frame), Height);
+        expectEqual(lcdImage.dirtyBegin(), 0);
+        expectEqual(lcdImage.dirtyEnd(), Height);
+        expectEqual(convert(lcdImage, frame), 0);
+    }
+
+}